@@ -13,3 +13,11 @@ Colour AmbientLight::CalculateContribution(const Vertex& position, const Vector3
 {
 	return ambient * GetIntensity();
 }
+
+//
+// Adds the light to the ambient light arrays of a packed light buffer.
+//
+void AmbientLight::Pack(LightBuffer& buffer)
+{
+	buffer.AddAmbient(GetIntensity());
+}
@@ -14,5 +14,10 @@ public:
 	// Return the intensity value as a constant for all polygons.
 	//
 	Colour CalculateContribution(const Vertex& position, const Vector3& normal, const Colour& ambient, const float& roughness, const float& specular) override;
+
+	//
+	// Adds the light to the ambient light arrays of a packed light buffer.
+	//
+	void Pack(LightBuffer& buffer) override;
 };
 
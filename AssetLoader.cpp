@@ -0,0 +1,107 @@
+#include "AssetLoader.h"
+
+//
+// Starts the loader threads.
+//
+AssetLoader::AssetLoader()
+{
+	for (unsigned int i = 0; i < LOADER_THREADS; ++i)
+	{
+		_workers.emplace_back(&AssetLoader::WorkerLoop, this);
+	}
+}
+
+//
+// Finishes the jobs already being run, and drops any still queued. Their
+// futures report a broken promise.
+//
+AssetLoader::~AssetLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_stopping = true;
+		_jobs.clear();
+	}
+
+	_wakeCondition.notify_all();
+
+	for (std::thread& worker : _workers)
+	{
+		worker.join();
+	}
+}
+
+//
+// Queues the mesh to be loaded. It is created on the loader thread and only
+// handed back once fully loaded, so nothing else can see it half way through.
+//
+std::future<std::unique_ptr<Mesh>> AssetLoader::LoadMesh(const std::string& fileName, const std::string& texture)
+{
+	// Jobs have to be copyable, which packaged tasks are not.
+	const auto task = std::make_shared<std::packaged_task<std::unique_ptr<Mesh>()>>([fileName, texture]()
+	{
+		std::unique_ptr<Mesh> mesh = std::make_unique<Mesh>();
+		mesh->LoadFromFile(fileName.c_str(), texture.empty() ? nullptr : texture.c_str());
+
+		return mesh;
+	});
+
+	std::future<std::unique_ptr<Mesh>> result = task->get_future();
+
+	Enqueue([task]()
+	{
+		(*task)();
+	});
+
+	return result;
+}
+
+//
+// Queues a job for the next free thread.
+//
+void AssetLoader::Enqueue(std::function<void()>&& job)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_jobs.push_back(std::move(job));
+	}
+
+	_wakeCondition.notify_one();
+}
+
+//
+// Runs jobs as they are queued, until the loader is destroyed.
+//
+void AssetLoader::WorkerLoop()
+{
+	while (true)
+	{
+		std::function<void()> job;
+
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wakeCondition.wait(lock, [&]() { return _stopping || !_jobs.empty(); });
+
+			if (_stopping)
+			{
+				return;
+			}
+
+			job = std::move(_jobs.front());
+			_jobs.pop_front();
+		}
+
+		job();
+	}
+}
+
+//
+// The loader shared by every scene object, started the first time it is used.
+//
+AssetLoader& AssetLoader::Get()
+{
+	static AssetLoader loader;
+	return loader;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <chrono>
+#include "Mesh.h"
+
+//
+// Loads assets in the background, on a small set of threads of its own, so
+// that reading and decoding files never holds up the frame. Meshes are
+// loaded entirely on those threads, texture included, and handed back
+// through a future once they are ready to be added to the scene.
+//
+class AssetLoader
+{
+public:
+	AssetLoader();
+	~AssetLoader();
+
+	AssetLoader(const AssetLoader&) = delete;
+	AssetLoader& operator=(const AssetLoader&) = delete;
+
+	//
+	// Loads a mesh and its texture (see Mesh::LoadFromFile). Failing to load
+	// it stores the exception in the future, which get() throws again.
+	//
+	std::future<std::unique_ptr<Mesh>> LoadMesh(const std::string& fileName, const std::string& texture = std::string());
+
+	//
+	// Whether the future holds a result (or an exception) which can be taken
+	// without blocking.
+	//
+	template<typename T>
+	static const bool IsReady(const std::future<T>& future);
+
+	static AssetLoader& Get();
+
+private:
+	void WorkerLoop();
+
+	//
+	// Queues a job for the next free thread.
+	//
+	void Enqueue(std::function<void()>&& job);
+
+	//
+	// Threads kept for loading. Loading is mostly spent waiting on the disk,
+	// so a couple of them are enough to keep it busy.
+	//
+	static constexpr unsigned int LOADER_THREADS = 2;
+
+private:
+	std::vector<std::thread> _workers;
+
+	std::mutex _mutex;
+	std::condition_variable _wakeCondition;
+	std::deque<std::function<void()>> _jobs;
+
+	bool _stopping{ false };
+};
+
+//
+// Whether the result can be taken without blocking.
+//
+template<typename T>
+inline const bool AssetLoader::IsReady(const std::future<T>& future)
+{
+	return future.valid() && future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
@@ -0,0 +1,751 @@
+#include "Benchmark.h"
+#include "Camera.h"
+#include "Bitmap.h"
+#include "Environment.h"
+#include "ThreadPool.h"
+#include "PcxDecoder.h"
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <cstdlib>
+#include <cmath>
+
+//
+// Amount of frames rendered (and thrown away) before timing a setting.
+//
+constexpr int WARMUP_FRAMES = 3;
+
+//
+// Amount of frames timed for every setting.
+//
+constexpr int TIMED_FRAMES = 30;
+
+//
+// Largest difference (per colour channel, out of 255) allowed between a pixel
+// shaded by the vectorised phong kernel and by the scalar reference.
+//
+constexpr int KERNEL_TOLERANCE = 2;
+
+//
+// Amount of vertices transformed by the vertex transform benchmark, and how
+// many times they are all transformed.
+//
+constexpr size_t TRANSFORM_VERTICES = 100000;
+constexpr int TRANSFORM_PASSES = 20;
+
+//
+// Amount of poses interpolated by the keyframe animation benchmark.
+//
+constexpr int ANIMATION_POSES = 10000;
+
+//
+// Amount of times the figurine is loaded by the mesh loading benchmark, as if
+// a scene held as many assets.
+//
+constexpr int LOADED_ASSETS = 200;
+
+//
+// Amount of times each texture is decoded by the texture decoding benchmark.
+//
+constexpr int TEXTURE_DECODES = 200;
+
+//
+// Texels sampled per pass of the texture sampling benchmark, and the passes.
+//
+constexpr int TEXTURE_SAMPLES = 1 << 20;
+constexpr int TEXTURE_PASSES = 20;
+
+//
+// Initialises the benchmark scene (same as the simple demo's).
+//
+void Benchmark::OnInit()
+{
+	_pedistal = CreateShape<Mesh>();
+	_pedistal->LoadFromFile("Meshes/cube.md2", "lines.pcx");
+	_pedistal->SetColour(Colour::White);
+	_pedistal->Mode(Mesh::DrawMode::DRAW_FRAGMENT);
+	_pedistal->SetPosition({ 0, -43.f, 0 });
+
+	_figurine = CreateShape<Mesh>();
+	_figurine->LoadFromFile("Meshes/marvin.md2", "marvin.pcx");
+	_figurine->SetColour(Colour::White);
+	_figurine->Mode(Mesh::DrawMode::DRAW_FRAGMENT);
+
+	_directional = Environment::GetActive().CreateLight<DirectionalLight>().get();
+	_directional->SetDirection(Vector3(-1.f, -1.f, 1.f));
+	_directional->SetIntensity(Colour(1.f, 0.f, 0.f));
+
+	_ambient = Environment::GetActive().CreateLight<AmbientLight>().get();
+	_ambient->SetIntensity(Colour(.1f, .1f, .1f));
+
+	_point = Environment::GetActive().CreateLight<PointLight>().get();
+	_point->SetPosition(Vector3(0, 50, -50.f));
+	_point->SetIntensity(Colour(.5f, .5f, 1.f));
+
+	Camera::GetMainCamera()->SetPosition({ 0, 0, -50 });
+	Camera::GetMainCamera()->SetRotation({ 0, 0, 0 });
+}
+
+//
+// Runs every benchmark once a bitmap is available to render into.
+//
+void Benchmark::OnTick(const float& deltaTime)
+{
+	if (_hasRun || !Bitmap::GetActive())
+	{
+		return;
+	}
+
+	_hasRun = true;
+
+	RunThreadScaling();
+	RunEngineComparison();
+	RunKernelComparison();
+	RunTransformComparison();
+	RunAnimationThroughput();
+	RunLoadComparison();
+	RunTextureDecode();
+	RunTextureSampling();
+	RunTextureFiltering();
+}
+
+//
+// Frame time of the binned rasteriser against the amount of threads
+// rasterising tiles, for every fragment shading mode.
+//
+void Benchmark::RunThreadScaling()
+{
+	const unsigned int hardwareThreads = max(std::thread::hardware_concurrency(), 1u);
+
+	std::vector<unsigned int> threadCounts;
+
+	for (unsigned int threads = 1; threads < hardwareThreads; threads *= 2)
+	{
+		threadCounts.push_back(threads);
+	}
+
+	threadCounts.push_back(hardwareThreads);
+
+	Log("-- Tile binned rasteriser: frame time against thread count --");
+
+	for (const Mesh::ShadeMode mode : { Mesh::ShadeMode::SHADE_FLAT, Mesh::ShadeMode::SHADE_GOURAUD, Mesh::ShadeMode::SHADE_PHONG, Mesh::ShadeMode::SHADE_DEFERRED })
+	{
+		SetShadeMode(mode);
+
+		_pedistal->Bin(false);
+		_figurine->Bin(false);
+
+		const double serial = TimeFrames(TIMED_FRAMES);
+
+		std::ostringstream ss;
+		ss << std::fixed << std::setprecision(3);
+		ss << GetShadeModeName(mode) << "\tserial\t\t" << serial << " ms";
+		Log(ss.str());
+
+		_pedistal->Bin(true);
+		_figurine->Bin(true);
+
+		for (const unsigned int& threads : threadCounts)
+		{
+			ThreadPool::Get().Resize(threads);
+
+			const double binned = TimeFrames(TIMED_FRAMES);
+
+			ss.str("");
+			ss << GetShadeModeName(mode) << "\t" << threads << " thread(s)\t" << binned << " ms (x" << serial / binned << ")";
+			Log(ss.str());
+		}
+	}
+
+	ThreadPool::Get().Resize(hardwareThreads);
+}
+
+//
+// Frame time of the scanline rasteriser against the half-space one, for
+// each mesh on its own and every fragment shading mode.
+//
+void Benchmark::RunEngineComparison()
+{
+	Log("-- Rasteriser engines: frame time per mesh --");
+
+	_pedistal->Bin(false);
+	_figurine->Bin(false);
+
+	const std::pair<Mesh*, const char*> meshes[]{ { _pedistal, "cube.md2" }, { _figurine, "marvin.md2" } };
+
+	for (const auto& [mesh, meshName] : meshes)
+	{
+		_pedistal->Mode(Mesh::DrawMode::DRAW_NONE);
+		_figurine->Mode(Mesh::DrawMode::DRAW_NONE);
+		mesh->Mode(Mesh::DrawMode::DRAW_FRAGMENT);
+
+		for (const Mesh::ShadeMode mode : { Mesh::ShadeMode::SHADE_FLAT, Mesh::ShadeMode::SHADE_GOURAUD, Mesh::ShadeMode::SHADE_PHONG, Mesh::ShadeMode::SHADE_DEFERRED })
+		{
+			SetShadeMode(mode);
+
+			double times[2]{ 0, 0 };
+			const Mesh::RasterEngine engines[2]{ Mesh::RasterEngine::ENGINE_SCANLINE, Mesh::RasterEngine::ENGINE_HALFSPACE };
+
+			for (int i = 0; i < 2; ++i)
+			{
+				mesh->Engine(engines[i]);
+				times[i] = TimeFrames(TIMED_FRAMES);
+			}
+
+			std::ostringstream ss;
+			ss << std::fixed << std::setprecision(3);
+			ss << meshName << "\t" << GetShadeModeName(mode) << "\t";
+			ss << GetEngineName(engines[0]) << " " << times[0] << " ms\t";
+			ss << GetEngineName(engines[1]) << " " << times[1] << " ms (x" << times[0] / times[1] << ")";
+			Log(ss.str());
+		}
+
+		mesh->Engine(Mesh::RasterEngine::ENGINE_SCANLINE);
+	}
+
+	_pedistal->Mode(Mesh::DrawMode::DRAW_FRAGMENT);
+	_figurine->Mode(Mesh::DrawMode::DRAW_FRAGMENT);
+}
+
+//
+// Golden image test of the vectorised phong kernel against the scalar one it
+// replaces, along with the frame time of both.
+//
+void Benchmark::RunKernelComparison()
+{
+	Log("-- Phong kernel: vectorised against scalar reference --");
+
+	SetShadeMode(Mesh::ShadeMode::SHADE_PHONG);
+
+	_pedistal->Bin(false);
+	_figurine->Bin(false);
+
+	_pedistal->Vectorise(false);
+	_figurine->Vectorise(false);
+
+	const double scalar = TimeFrames(TIMED_FRAMES);
+
+	const FrameBuffer frame = Bitmap::GetActive()->GetFrameBuffer();
+	const std::vector<UINT32> reference(frame.pixels, frame.pixels + frame.width * frame.height);
+
+	_pedistal->Vectorise(true);
+	_figurine->Vectorise(true);
+
+	const double vectorised = TimeFrames(TIMED_FRAMES);
+
+	int differences = 0;
+	int largestDifference = 0;
+
+	for (size_t i = 0; i < reference.size(); ++i)
+	{
+		int difference = 0;
+
+		for (int shift = 0; shift < 24; shift += 8)
+		{
+			const int channel = static_cast<int>((reference[i] >> shift) & 0xFF) - static_cast<int>((frame.pixels[i] >> shift) & 0xFF);
+			difference = max(difference, abs(channel));
+		}
+
+		differences += difference > KERNEL_TOLERANCE;
+		largestDifference = max(largestDifference, difference);
+	}
+
+	std::ostringstream ss;
+	ss << std::fixed << std::setprecision(3);
+	ss << "Phong\tscalar " << scalar << " ms\tSSE " << vectorised << " ms (x" << scalar / vectorised << ")";
+	Log(ss.str());
+
+	ss.str("");
+	ss << "Golden image: " << (differences ? "FAILED" : "passed") << ", " << differences << " pixel(s) off by more than " << KERNEL_TOLERANCE << ", largest difference " << largestDifference;
+	Log(ss.str());
+}
+
+//
+// Reference for the batched kernel: transforms the positions of the source
+// buffer by the matrix, one vertex at a time, into the destination (which may
+// be the source itself).
+//
+static void TransformPositions(const Matrix& matrix, const VertexBuffer& source, VertexBuffer& destination)
+{
+	const size_t count = source.GetCount();
+
+	if (&source != &destination)
+	{
+		destination.Resize(count);
+	}
+
+	float m[ROWS][COLS];
+
+	for (int row = 0; row < ROWS; ++row)
+	{
+		for (int column = 0; column < COLS; ++column)
+		{
+			m[row][column] = matrix.GetM(row, column);
+		}
+	}
+
+	const float* sourceX = source.GetX();
+	const float* sourceY = source.GetY();
+	const float* sourceZ = source.GetZ();
+	const float* sourceW = source.GetW();
+	float* destinationX = destination.GetX();
+	float* destinationY = destination.GetY();
+	float* destinationZ = destination.GetZ();
+	float* destinationW = destination.GetW();
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const float x = sourceX[i];
+		const float y = sourceY[i];
+		const float z = sourceZ[i];
+		const float w = sourceW[i];
+
+		destinationX[i] = m[0][0] * x + m[0][1] * y + m[0][2] * z + m[0][3] * w;
+		destinationY[i] = m[1][0] * x + m[1][1] * y + m[1][2] * z + m[1][3] * w;
+		destinationZ[i] = m[2][0] * x + m[2][1] * y + m[2][2] * z + m[2][3] * w;
+		destinationW[i] = m[3][0] * x + m[3][1] * y + m[3][2] * z + m[3][3] * w;
+	}
+}
+
+//
+// Reference for the batched kernel: divides every position by its W
+// component, keeping W as the depth.
+//
+static void DehomogenisePositions(VertexBuffer& buffer)
+{
+	const size_t count = buffer.GetCount();
+	float* x = buffer.GetX();
+	float* y = buffer.GetY();
+	float* z = buffer.GetZ();
+	float* w = buffer.GetW();
+	float* depth = buffer.GetDepth();
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		depth[i] = w[i];
+
+		x[i] /= w[i];
+		y[i] /= w[i];
+		z[i] /= w[i];
+		w[i] = 1; /* w/w = 1 */
+	}
+}
+
+//
+// Vertices transformed per second by the array of vertices layout (one
+// matrix multiply per vertex) against the structure of arrays vertex buffer,
+// and by the separate world, projection and clip passes against the batched
+// SSE kernel doing all of them at once.
+//
+void Benchmark::RunTransformComparison()
+{
+	Log("-- Vertex transform: array of vertices against structure of arrays --");
+
+	std::vector<Vertex> vertices;
+	std::vector<Vertex> transformed(TRANSFORM_VERTICES);
+	VertexBuffer source;
+	VertexBuffer destination;
+	VertexBuffer clipSpace;
+
+	vertices.reserve(TRANSFORM_VERTICES);
+
+	for (size_t i = 0; i < TRANSFORM_VERTICES; ++i)
+	{
+		const float t = static_cast<float>(i);
+		Vertex vertex(t, t * .5f, t * .25f, 1);
+
+		vertices.push_back(vertex);
+		source.Add(vertex);
+	}
+
+	const Camera* const camera = Camera::GetMainCamera();
+	const Matrix view = camera->GetWorldToCameraMatrix();
+	const Matrix projection = camera->GetProjectionMatrix();
+	const Matrix projectionToClip = camera->GetProjectionToClipMatrix();
+	const Matrix transform = projection * view;
+
+	const auto timePasses = [](const auto& pass)
+	{
+		pass();
+
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		for (int i = 0; i < TRANSFORM_PASSES; ++i)
+		{
+			pass();
+		}
+
+		const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+		return TRANSFORM_VERTICES * TRANSFORM_PASSES / elapsed.count();
+	};
+
+	const double arrayOfVertices = timePasses([&]()
+	{
+		for (size_t i = 0; i < TRANSFORM_VERTICES; ++i)
+		{
+			transformed[i] = transform * vertices[i];
+		}
+	});
+
+	const double structureOfArrays = timePasses([&]()
+	{
+		TransformPositions(transform, source, destination);
+	});
+
+	std::ostringstream ss;
+	ss << std::fixed << std::setprecision(1);
+	ss << TRANSFORM_VERTICES << " vertices\tAoS " << arrayOfVertices / 1e6 << " Mvert/s\tSoA " << structureOfArrays / 1e6 << " Mvert/s (x" << structureOfArrays / arrayOfVertices << ")";
+	Log(ss.str());
+
+	const double separatePasses = timePasses([&]()
+	{
+		TransformPositions(view, source, destination);
+		TransformPositions(projection, destination, clipSpace);
+		DehomogenisePositions(clipSpace);
+		TransformPositions(projectionToClip, clipSpace, clipSpace);
+	});
+
+	const double batched = timePasses([&]()
+	{
+		Matrix::TransformBatch(view, projectionToClip * transform, source, destination, clipSpace);
+	});
+
+	ss.str("");
+	ss << TRANSFORM_VERTICES << " vertices\tseparate passes " << separatePasses / 1e6 << " Mvert/s\tbatched " << batched / 1e6 << " Mvert/s (x" << batched / separatePasses << ")";
+	Log(ss.str());
+}
+
+//
+// Time taken to pose a character, interpolating between consecutive keyframes
+// of the figurine, which is what every animated mesh in view costs per frame
+// (before its normals are recalculated).
+//
+void Benchmark::RunAnimationThroughput()
+{
+	Log("-- Keyframe animation: dequantise and blend two frames --");
+
+	const KeyframeStore& keyframes = _figurine->GetKeyframes();
+	const int frameCount = keyframes.GetFrameCount();
+
+	if (frameCount == 0)
+	{
+		return;
+	}
+
+	VertexBuffer pose;
+	pose.Resize(keyframes.GetVertexCount());
+
+	keyframes.Interpolate(0, 0, 0, pose);
+
+	const auto start = std::chrono::high_resolution_clock::now();
+
+	for (int i = 0; i < ANIMATION_POSES; ++i)
+	{
+		keyframes.Interpolate(i % frameCount, (i + 1) % frameCount, .5f, pose);
+	}
+
+	const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+	const double vertices = static_cast<double>(keyframes.GetVertexCount()) * ANIMATION_POSES;
+
+	std::ostringstream ss;
+	ss << std::fixed << std::setprecision(2);
+	ss << keyframes.GetVertexCount() << " vertices, " << frameCount << " frames\t" << elapsed.count() * 1e6 / ANIMATION_POSES << " us/pose\t" << vertices / elapsed.count() / 1e6 << " Mvert/s";
+	Log(ss.str());
+}
+
+//
+// Time taken to load the figurine as many times as a scene holds assets, by
+// parsing the MD2 file and its texture against reading the mesh cache.
+//
+void Benchmark::RunLoadComparison()
+{
+	Log("-- Mesh loading: MD2 against mesh cache --");
+
+	const auto timeLoads = [](const bool& useCache)
+	{
+		Mesh mesh;
+		mesh.LoadFromFile("Meshes/marvin.md2", "marvin.pcx", useCache);
+
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		for (int i = 0; i < LOADED_ASSETS; ++i)
+		{
+			mesh.LoadFromFile("Meshes/marvin.md2", "marvin.pcx", useCache);
+		}
+
+		const std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+		return elapsed.count();
+	};
+
+	const double parsed = timeLoads(false);
+	const double cached = timeLoads(true);
+
+	std::ostringstream ss;
+	ss << std::fixed << std::setprecision(1);
+	ss << LOADED_ASSETS << " loads\tMD2 " << parsed << " ms\tcache " << cached << " ms (x" << parsed / cached << ")";
+	Log(ss.str());
+}
+
+//
+// Texels decoded per second from each of the scene's PCX textures, including
+// mapping and reading the file.
+//
+void Benchmark::RunTextureDecode()
+{
+	Log("-- PCX decoding: file to 32-bit texels --");
+
+	for (const char* const fileName : { "marvin.pcx", "lines.pcx" })
+	{
+		Texture texture;
+
+		if (!PcxDecoder::Load(fileName, texture))
+		{
+			Log(std::string(fileName) + "\tcould not be decoded");
+			continue;
+		}
+
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		for (int i = 0; i < TEXTURE_DECODES; ++i)
+		{
+			PcxDecoder::Load(fileName, texture);
+		}
+
+		const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+		const double texels = static_cast<double>(texture.GetWidth()) * texture.GetHeight() * TEXTURE_DECODES;
+
+		std::ostringstream ss;
+		ss << std::fixed << std::setprecision(1);
+		ss << fileName << "\t" << texture.GetWidth() << "x" << texture.GetHeight() << "\t" << elapsed.count() * 1e6 / TEXTURE_DECODES << " us/decode\t" << texels / elapsed.count() / 1e6 << " Mtexel/s";
+		Log(ss.str());
+	}
+}
+
+//
+// Texels sampled per second from the palette, which every sample used to go
+// through, against the tiled texels in either addressing mode. Spans cross
+// the texture at an angle, as they do over most of a textured model.
+//
+void Benchmark::RunTextureSampling()
+{
+	Log("-- Texture sampling: palette indices against tiled texels --");
+
+	Texture texture;
+
+	if (!PcxDecoder::Load("marvin.pcx", texture))
+	{
+		Log("marvin.pcx\tcould not be decoded");
+		return;
+	}
+
+	std::vector<int> u(TEXTURE_SAMPLES);
+	std::vector<int> v(TEXTURE_SAMPLES);
+
+	const float width = static_cast<float>(texture.GetWidth());
+	const float height = static_cast<float>(texture.GetHeight());
+
+	for (int i = 0; i < TEXTURE_SAMPLES; ++i)
+	{
+		// A new span every 128 samples, starting a little further down the texture.
+		const float span = static_cast<float>(i / 128);
+		const float step = static_cast<float>(i % 128);
+
+		u[i] = static_cast<int>(fmodf(span * 3.f + step * .8f, width));
+		v[i] = static_cast<int>(fmodf(span * 5.f + step * .6f, height));
+	}
+
+	const auto timeSamples = [&](const auto& sample, UINT32& checksum)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+
+		for (int pass = 0; pass < TEXTURE_PASSES; ++pass)
+		{
+			checksum = 0;
+
+			for (int i = 0; i < TEXTURE_SAMPLES; ++i)
+			{
+				checksum += sample(u[i], v[i]);
+			}
+		}
+
+		const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+		return static_cast<double>(TEXTURE_SAMPLES) * TEXTURE_PASSES / elapsed.count();
+	};
+
+	UINT32 paletteChecksum = 0;
+	UINT32 clampChecksum = 0;
+	UINT32 wrapChecksum = 0;
+
+	const double palette = timeSamples([&](const int& x, const int& y) { return FrameBuffer::FromColorRef(texture.GetTextureValue(x, y)); }, paletteChecksum);
+	const double clamp = timeSamples([&](const int& x, const int& y) { return texture.Sample<TextureAddress::ADDRESS_CLAMP>(x, y); }, clampChecksum);
+
+	std::ostringstream ss;
+	ss << std::fixed << std::setprecision(1);
+	ss << "palette " << palette / 1e6 << " Msample/s\ttiled clamp " << clamp / 1e6 << " Msample/s (x" << clamp / palette << ")";
+
+	bool isMatching = paletteChecksum == clampChecksum;
+
+	// Every coordinate is within the texture, so wrapping must not change any sample either.
+	if (texture.IsPowerOfTwo())
+	{
+		const double wrap = timeSamples([&](const int& x, const int& y) { return texture.Sample<TextureAddress::ADDRESS_WRAP>(x, y); }, wrapChecksum);
+
+		ss << "\ttiled wrap " << wrap / 1e6 << " Msample/s (x" << wrap / palette << ")";
+
+		isMatching = isMatching && wrapChecksum == paletteChecksum;
+	}
+
+	ss << (isMatching ? "\tsamples match" : "\tSAMPLES DIFFER");
+	Log(ss.str());
+}
+
+//
+// Frame time of the figurine with every texture filter, close to the camera
+// and far enough away for its skin to be minified several times over.
+//
+void Benchmark::RunTextureFiltering()
+{
+	Log("-- Texture filtering: frame time of the figurine near and far --");
+
+	SetShadeMode(Mesh::ShadeMode::SHADE_PHONG);
+
+	_pedistal->Mode(Mesh::DrawMode::DRAW_NONE);
+	_figurine->Bin(false);
+
+	const std::pair<float, const char*> distances[]{ { -50.f, "near" }, { -600.f, "far" } };
+
+	for (const auto& [distance, distanceName] : distances)
+	{
+		Camera::GetMainCamera()->SetPosition({ 0, 0, distance });
+
+		_figurine->Filter(TextureFilter::FILTER_NEAREST);
+		const double nearest = TimeFrames(TIMED_FRAMES);
+
+		for (const TextureFilter filter : { TextureFilter::FILTER_NEAREST, TextureFilter::FILTER_MIPMAP, TextureFilter::FILTER_BILINEAR, TextureFilter::FILTER_TRILINEAR })
+		{
+			_figurine->Filter(filter);
+
+			const double time = filter == TextureFilter::FILTER_NEAREST ? nearest : TimeFrames(TIMED_FRAMES);
+
+			std::ostringstream ss;
+			ss << std::fixed << std::setprecision(3);
+			ss << distanceName << "\t" << GetFilterName(filter) << "\t" << time << " ms (x" << nearest / time << ")";
+			Log(ss.str());
+		}
+	}
+
+	Camera::GetMainCamera()->SetPosition({ 0, 0, -50 });
+
+	_pedistal->Mode(Mesh::DrawMode::DRAW_FRAGMENT);
+	_figurine->Filter(TextureFilter::FILTER_MIPMAP);
+}
+
+//
+// Switches both meshes to the given shading mode.
+//
+void Benchmark::SetShadeMode(const Mesh::ShadeMode& mode)
+{
+	_pedistal->Shade(mode);
+	_figurine->Shade(mode);
+}
+
+//
+// Renders the environment into the active bitmap a number of times and
+// returns the average time a frame took, in milliseconds.
+//
+const double Benchmark::TimeFrames(const int& frameCount) const
+{
+	const Bitmap* const bitmap = Bitmap::GetActive();
+	Environment& environment = Environment::GetActive();
+
+	const auto renderFrame = [&]()
+	{
+		bitmap->Clear(environment.GetBackgroundColour());
+		bitmap->ClearDepth();
+		environment.OnRender(bitmap->GetDC());
+	};
+
+	for (int i = 0; i < WARMUP_FRAMES; ++i)
+	{
+		renderFrame();
+	}
+
+	const auto start = std::chrono::high_resolution_clock::now();
+
+	for (int i = 0; i < frameCount; ++i)
+	{
+		renderFrame();
+	}
+
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+	return elapsed.count() / frameCount;
+}
+
+//
+// Logs a message to the output console (Visual Studio only).
+//
+void Benchmark::Log(const std::string& message)
+{
+	OutputDebugStringA((message + '\n').c_str());
+}
+
+//
+// Readable name of a shading mode.
+//
+const char* const Benchmark::GetShadeModeName(const Mesh::ShadeMode& mode)
+{
+	switch (mode)
+	{
+	case Mesh::ShadeMode::SHADE_FLAT:
+		return "Flat";
+	case Mesh::ShadeMode::SHADE_GOURAUD:
+		return "Gouraud";
+	case Mesh::ShadeMode::SHADE_PHONG:
+		return "Phong";
+	case Mesh::ShadeMode::SHADE_DEFERRED:
+		return "Deferred";
+	default:
+		return "Unknown";
+	}
+}
+
+//
+// Readable name of a rasteriser engine.
+//
+const char* const Benchmark::GetEngineName(const Mesh::RasterEngine& engine)
+{
+	switch (engine)
+	{
+	case Mesh::RasterEngine::ENGINE_SCANLINE:
+		return "Scanline";
+	case Mesh::RasterEngine::ENGINE_HALFSPACE:
+		return "Half-space";
+	default:
+		return "Unknown";
+	}
+}
+
+//
+// Readable name of a texture filter.
+//
+const char* const Benchmark::GetFilterName(const TextureFilter& filter)
+{
+	switch (filter)
+	{
+	case TextureFilter::FILTER_NEAREST:
+		return "Nearest";
+	case TextureFilter::FILTER_MIPMAP:
+		return "Mipmap";
+	case TextureFilter::FILTER_BILINEAR:
+		return "Bilinear";
+	case TextureFilter::FILTER_TRILINEAR:
+		return "Trilinear";
+	default:
+		return "Unknown";
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "SceneObject.h"
+#include "DirectionalLight.h"
+#include "AmbientLight.h"
+#include "PointLight.h"
+#include "Mesh.h"
+#include <string>
+
+//
+// Renders a fixed scene over and over under different renderer settings
+// and logs how long a frame takes with each of them to the output console
+// (Visual Studio only). Runs once, on the first frame with an active bitmap.
+//
+class Benchmark : public SceneObject
+{
+public:
+	// Initialisation...
+	void OnInit() override;
+
+	// On tick...
+	void OnTick(const float& deltaTime) override;
+
+private:
+	//
+	// Benchmarks
+	//
+	void RunThreadScaling();
+	void RunEngineComparison();
+	void RunKernelComparison();
+	void RunTransformComparison();
+	void RunAnimationThroughput();
+	void RunLoadComparison();
+	void RunTextureDecode();
+	void RunTextureSampling();
+	void RunTextureFiltering();
+
+	//
+	// Utilities
+	//
+	void SetShadeMode(const Mesh::ShadeMode& mode);
+	const double TimeFrames(const int& frameCount) const;
+
+	static void Log(const std::string& message);
+	static const char* const GetShadeModeName(const Mesh::ShadeMode& mode);
+	static const char* const GetEngineName(const Mesh::RasterEngine& engine);
+	static const char* const GetFilterName(const TextureFilter& filter);
+
+private:
+	bool _hasRun = false;
+
+	// Pedistal and figurine.
+	Mesh* _pedistal = nullptr;
+	Mesh* _figurine = nullptr;
+
+	// Light
+	DirectionalLight* _directional = nullptr;
+	AmbientLight* _ambient = nullptr;
+	PointLight* _point = nullptr;
+};
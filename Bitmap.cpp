@@ -1,4 +1,5 @@
 #include "Bitmap.h"
+#include <algorithm>
 
 const Bitmap* Bitmap::_activeBitmap;
 
@@ -31,10 +32,29 @@ bool Bitmap::Create(HWND hWnd, unsigned int width, unsigned int height)
 	_hMemDC = CreateCompatibleDC(hDc);
 	if (_hMemDC != 0)
 	{
-		// Create a bitmap compatible with the window
-		_hBitmap = CreateCompatibleBitmap(hDc, _width, _height);
+		// Create a 32-bit top-down DIB section so that the rasteriser can write
+		// straight into its memory, GDI is only needed to blit it to the window
+		BITMAPINFO info{};
+		info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+		info.bmiHeader.biWidth = static_cast<LONG>(_width);
+		info.bmiHeader.biHeight = -static_cast<LONG>(_height);
+		info.bmiHeader.biPlanes = 1;
+		info.bmiHeader.biBitCount = 32;
+		info.bmiHeader.biCompression = BI_RGB;
+
+		void* bits = nullptr;
+		_hBitmap = CreateDIBSection(hDc, &info, DIB_RGB_COLORS, &bits, NULL, 0);
 		if (_hBitmap != 0)
 		{
+			_frameBuffer.pixels = static_cast<UINT32*>(bits);
+			_frameBuffer.width = static_cast<int>(_width);
+			_frameBuffer.height = static_cast<int>(_height);
+			_frameBuffer.clipRight = _frameBuffer.width;
+			_frameBuffer.clipBottom = _frameBuffer.height;
+
+			_depthBuffer.assign(static_cast<size_t>(_width) * _height, 0.0f);
+			_frameBuffer.depth = _depthBuffer.data();
+
 			// Select the bitmap into the new device context, saving any old bitmap handle
 			_hOldBitmap = static_cast<HBITMAP>(SelectObject(_hMemDC, _hBitmap));
 			status = true;
@@ -66,10 +86,22 @@ unsigned int Bitmap::GetHeight() const
 	return _height;
 }
 
+// Return the raw colour buffer of the bitmap. Any GDI work still queued up
+// for the device context is flushed first so that direct writes never race it.
+
+const FrameBuffer& Bitmap::GetFrameBuffer() const
+{
+	GdiFlush();
+	return _frameBuffer;
+}
+
 // Delete any existing bitmap
 
 void Bitmap::DeleteBitmap()
 {
+	_frameBuffer = FrameBuffer();
+	_depthBuffer.clear();
+
 	// Select any default bitmap that existed for the device context
 	if (_hOldBitmap != 0 && _hMemDC != 0)
 	{
@@ -103,13 +135,30 @@ void Bitmap::Clear(HBRUSH hBrush) const
 	FillRect(_hMemDC, &rect, hBrush);
 }
 
-// Clear bitmap using the specified colour
+// Clear bitmap using the specified colour, writing straight into the colour buffer
 
 void Bitmap::Clear(COLORREF colour) const
 {
-	HBRUSH brush = CreateSolidBrush(colour);
-	Clear(brush);
-	DeleteObject(brush);
+	const FrameBuffer& target = GetFrameBuffer();
+
+	if (!target.pixels)
+	{
+		return;
+	}
+
+	std::fill_n(target.pixels, static_cast<size_t>(target.width) * target.height, FrameBuffer::FromColorRef(colour));
+}
+
+// Reset the depth buffer so that every pixel is infinitely far away
+
+void Bitmap::ClearDepth() const
+{
+	if (!_frameBuffer.depth)
+	{
+		return;
+	}
+
+	std::fill_n(_frameBuffer.depth, _depthBuffer.size(), 0.0f);
 }
 
 void Bitmap::MakeActive() const
@@ -1,5 +1,7 @@
 #pragma once
 #include "windows.h"
+#include "FrameBuffer.h"
+#include <vector>
 
 class Bitmap
 {
@@ -13,6 +15,9 @@ public:
 	unsigned int	GetHeight() const;
 	void			Clear(HBRUSH hBrush) const;
 	void			Clear(COLORREF colour) const;
+	void			ClearDepth() const;
+
+	const FrameBuffer& GetFrameBuffer() const;
 
 	void					   MakeActive() const;
 	static const Bitmap* const GetActive();
@@ -23,6 +28,9 @@ private:
 	HDC				_hMemDC{ 0 };
 	unsigned int	_width{ 0 };
 	unsigned int	_height{ 0 };
+	FrameBuffer		_frameBuffer;
+
+	std::vector<float> _depthBuffer;
 
 	// Active bitmap
 	static const Bitmap* _activeBitmap;
@@ -0,0 +1,326 @@
+#include "Bounds.h"
+#include <cmath>
+#include <cfloat>
+
+//
+// The centre of the box.
+//
+const Vector3 BoundingBox::GetCentre() const
+{
+	return (minimum + maximum) * .5f;
+}
+
+//
+// Half the size of the box along every axis.
+//
+const Vector3 BoundingBox::GetExtents() const
+{
+	return (maximum - minimum) * .5f;
+}
+
+//
+// Half the surface area of the box.
+//
+const float BoundingBox::GetHalfArea() const
+{
+	const Vector3 size = maximum - minimum;
+
+	return size.GetX() * size.GetY() + size.GetY() * size.GetZ() + size.GetZ() * size.GetX();
+}
+
+//
+// Grows the box so that it also contains the given box.
+//
+void BoundingBox::Encapsulate(const BoundingBox& other)
+{
+	minimum = Vector3(min(minimum.GetX(), other.minimum.GetX()), min(minimum.GetY(), other.minimum.GetY()), min(minimum.GetZ(), other.minimum.GetZ()));
+	maximum = Vector3(max(maximum.GetX(), other.maximum.GetX()), max(maximum.GetY(), other.maximum.GetY()), max(maximum.GetZ(), other.maximum.GetZ()));
+}
+
+//
+// The box grown by the given margin along every axis.
+//
+const BoundingBox BoundingBox::Expand(const Vector3& margin) const
+{
+	return { minimum - margin, maximum + margin };
+}
+
+//
+// Whether the given box lies entirely within this one.
+//
+const bool BoundingBox::Contains(const BoundingBox& other) const
+{
+	return minimum.GetX() <= other.minimum.GetX() && minimum.GetY() <= other.minimum.GetY() && minimum.GetZ() <= other.minimum.GetZ()
+		&& maximum.GetX() >= other.maximum.GetX() && maximum.GetY() >= other.maximum.GetY() && maximum.GetZ() >= other.maximum.GetZ();
+}
+
+//
+// Whether the two boxes overlap.
+//
+const bool BoundingBox::Intersects(const BoundingBox& other) const
+{
+	return minimum.GetX() <= other.maximum.GetX() && minimum.GetY() <= other.maximum.GetY() && minimum.GetZ() <= other.maximum.GetZ()
+		&& maximum.GetX() >= other.minimum.GetX() && maximum.GetY() >= other.minimum.GetY() && maximum.GetZ() >= other.minimum.GetZ();
+}
+
+//
+// Whether the sphere overlaps the box, from the distance between its centre
+// and the closest point of the box.
+//
+const bool BoundingBox::Intersects(const BoundingSphere& sphere) const
+{
+	const Vector3 closest
+	(
+		min(max(sphere.centre.GetX(), minimum.GetX()), maximum.GetX()),
+		min(max(sphere.centre.GetY(), minimum.GetY()), maximum.GetY()),
+		min(max(sphere.centre.GetZ(), minimum.GetZ()), maximum.GetZ())
+	);
+
+	return (closest - sphere.centre).GetSqrMagnitude() <= sphere.radius * sphere.radius;
+}
+
+//
+// Slab test: the ray hits the box when the distances at which it crosses the
+// planes of each axis all overlap, somewhere in front of its origin. A ray
+// parallel to an axis never crosses its planes, and only hits the box if it
+// starts between them (rather than multiplying an infinite reciprocal by a
+// zero distance, which gives NaN for origins on a plane).
+//
+const bool BoundingBox::Raycast(const Vector3& origin, const Vector3& inverseDirection, float& distance) const
+{
+	const float source[3]{ origin.GetX(), origin.GetY(), origin.GetZ() };
+	const float inverse[3]{ inverseDirection.GetX(), inverseDirection.GetY(), inverseDirection.GetZ() };
+	const float lower[3]{ minimum.GetX(), minimum.GetY(), minimum.GetZ() };
+	const float upper[3]{ maximum.GetX(), maximum.GetY(), maximum.GetZ() };
+
+	float nearest = 0;
+	float furthest = FLT_MAX;
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		if (std::isinf(inverse[axis]))
+		{
+			if (source[axis] < lower[axis] || source[axis] > upper[axis])
+			{
+				return false;
+			}
+
+			continue;
+		}
+
+		const float a = (lower[axis] - source[axis]) * inverse[axis];
+		const float b = (upper[axis] - source[axis]) * inverse[axis];
+
+		nearest = max(nearest, min(a, b));
+		furthest = min(furthest, max(a, b));
+	}
+
+	distance = nearest;
+
+	return nearest <= furthest;
+}
+
+//
+// The box containing this box after being transformed by the (affine) matrix.
+// Every axis of the result is built from the smallest and largest
+// contribution of each source axis, rather than transforming all eight corners.
+//
+const BoundingBox BoundingBox::Transform(const Matrix& matrix) const
+{
+	const float source[2][3]
+	{
+		{ minimum.GetX(), minimum.GetY(), minimum.GetZ() },
+		{ maximum.GetX(), maximum.GetY(), maximum.GetZ() }
+	};
+
+	float target[2][3];
+
+	for (int row = 0; row < 3; ++row)
+	{
+		target[0][row] = matrix.GetM(row, 3);
+		target[1][row] = matrix.GetM(row, 3);
+
+		for (int column = 0; column < 3; ++column)
+		{
+			const float a = matrix.GetM(row, column) * source[0][column];
+			const float b = matrix.GetM(row, column) * source[1][column];
+
+			target[0][row] += min(a, b);
+			target[1][row] += max(a, b);
+		}
+	}
+
+	return { { target[0][0], target[0][1], target[0][2] }, { target[1][0], target[1][1], target[1][2] } };
+}
+
+//
+// The smallest box containing every vertex.
+//
+const BoundingBox BoundingBox::FromVertices(const VertexBuffer& vertices)
+{
+	const size_t count = vertices.GetCount();
+
+	if (count == 0)
+	{
+		return BoundingBox();
+	}
+
+	const float* x = vertices.GetX();
+	const float* y = vertices.GetY();
+	const float* z = vertices.GetZ();
+
+	float minimum[3]{ x[0], y[0], z[0] };
+	float maximum[3]{ x[0], y[0], z[0] };
+
+	for (size_t i = 1; i < count; ++i)
+	{
+		minimum[0] = min(minimum[0], x[i]);
+		minimum[1] = min(minimum[1], y[i]);
+		minimum[2] = min(minimum[2], z[i]);
+
+		maximum[0] = max(maximum[0], x[i]);
+		maximum[1] = max(maximum[1], y[i]);
+		maximum[2] = max(maximum[2], z[i]);
+	}
+
+	return { { minimum[0], minimum[1], minimum[2] }, { maximum[0], maximum[1], maximum[2] } };
+}
+
+//
+// The sphere containing this sphere after being transformed by the (affine)
+// matrix. The radius grows by the largest scale along any axis.
+//
+const BoundingSphere BoundingSphere::Transform(const Matrix& matrix) const
+{
+	float scale = 0;
+
+	for (int column = 0; column < 3; ++column)
+	{
+		const Vector3 axis(matrix.GetM(0, column), matrix.GetM(1, column), matrix.GetM(2, column));
+		scale = max(scale, axis.GetSqrMagnitude());
+	}
+
+	return { matrix * centre, radius * std::sqrt(scale) };
+}
+
+//
+// A sphere around the centre of the given bounds, reaching the furthest vertex.
+//
+const BoundingSphere BoundingSphere::FromVertices(const VertexBuffer& vertices, const BoundingBox& bounds)
+{
+	const size_t count = vertices.GetCount();
+	const Vector3 centre = bounds.GetCentre();
+
+	float radius = 0;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		radius = max(radius, (vertices.GetPosition(i) - centre).GetSqrMagnitude());
+	}
+
+	return { centre, std::sqrt(radius) };
+}
+
+//
+// Extracts the planes from the rows of a view-projection matrix. A point is
+// visible when -w <= x <= w and -w <= y <= w once projected, and when its w
+// (its distance along the view direction) is past the near plane.
+//
+void Frustum::Reset(const Matrix& viewProjection, const float& nearPlane)
+{
+	const auto getRow = [&](const int& row)
+	{
+		return Plane{ { viewProjection.GetM(row, 0), viewProjection.GetM(row, 1), viewProjection.GetM(row, 2) }, viewProjection.GetM(row, 3) };
+	};
+
+	const auto combine = [](const Plane& lhs, const Plane& rhs, const float& sign)
+	{
+		return Plane{ lhs.normal + rhs.normal * sign, lhs.offset + rhs.offset * sign };
+	};
+
+	const Plane x = getRow(0);
+	const Plane y = getRow(1);
+	const Plane w = getRow(3);
+
+	_planes[0] = combine(w, x, 1);
+	_planes[1] = combine(w, x, -1);
+	_planes[2] = combine(w, y, 1);
+	_planes[3] = combine(w, y, -1);
+	_planes[4] = { w.normal, w.offset - nearPlane };
+
+	// Normalise the planes, so that distances from them are in world units.
+	for (Plane& plane : _planes)
+	{
+		const float magnitude = plane.normal.GetMagnitude();
+
+		if (magnitude > 0)
+		{
+			plane.normal /= magnitude;
+			plane.offset /= magnitude;
+		}
+	}
+}
+
+//
+// Whether any part of the sphere is within the frustum.
+//
+const bool Frustum::Intersects(const BoundingSphere& sphere) const
+{
+	for (const Plane& plane : _planes)
+	{
+		if (plane.GetDistance(sphere.centre) < -sphere.radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//
+// Whether any part of the box is within the frustum. Only the corner of the
+// box furthest along each plane's normal is tested against it.
+//
+const bool Frustum::Intersects(const BoundingBox& box) const
+{
+	for (const Plane& plane : _planes)
+	{
+		const Vector3 corner
+		(
+			plane.normal.GetX() >= 0 ? box.maximum.GetX() : box.minimum.GetX(),
+			plane.normal.GetY() >= 0 ? box.maximum.GetY() : box.minimum.GetY(),
+			plane.normal.GetZ() >= 0 ? box.maximum.GetZ() : box.minimum.GetZ()
+		);
+
+		if (plane.GetDistance(corner) < 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+//
+// Whether the whole box is within the frustum. Only the corner of the box
+// nearest along each plane's normal is tested against it.
+//
+const bool Frustum::Contains(const BoundingBox& box) const
+{
+	for (const Plane& plane : _planes)
+	{
+		const Vector3 corner
+		(
+			plane.normal.GetX() >= 0 ? box.minimum.GetX() : box.maximum.GetX(),
+			plane.normal.GetY() >= 0 ? box.minimum.GetY() : box.maximum.GetY(),
+			plane.normal.GetZ() >= 0 ? box.minimum.GetZ() : box.maximum.GetZ()
+		);
+
+		if (plane.GetDistance(corner) < 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include "Vector.h"
+#include "Matrix.h"
+#include "VertexBuffer.h"
+
+struct BoundingSphere;
+
+//
+// Axis aligned bounding box.
+//
+struct BoundingBox
+{
+	Vector3 minimum;
+	Vector3 maximum;
+
+	const Vector3 GetCentre() const;
+	const Vector3 GetExtents() const;
+
+	//
+	// Half the surface area of the box, the cost of a node in a bounding
+	// volume hierarchy.
+	//
+	const float GetHalfArea() const;
+
+	//
+	// Grows the box so that it also contains the given box.
+	//
+	void Encapsulate(const BoundingBox& other);
+
+	//
+	// The box grown by the given margin along every axis.
+	//
+	const BoundingBox Expand(const Vector3& margin) const;
+
+	const bool Contains(const BoundingBox& other) const;
+	const bool Intersects(const BoundingBox& other) const;
+	const bool Intersects(const BoundingSphere& sphere) const;
+
+	//
+	// Whether a ray hits the box, given the reciprocal of its direction. The
+	// distance along the ray to where it enters the box is written to distance.
+	//
+	const bool Raycast(const Vector3& origin, const Vector3& inverseDirection, float& distance) const;
+
+	//
+	// The box containing this box after being transformed by the matrix.
+	//
+	const BoundingBox Transform(const Matrix& matrix) const;
+
+	static const BoundingBox FromVertices(const VertexBuffer& vertices);
+};
+
+//
+// Bounding sphere.
+//
+struct BoundingSphere
+{
+	Vector3 centre;
+	float radius{ 0 };
+
+	//
+	// The sphere containing this sphere after being transformed by the matrix.
+	//
+	const BoundingSphere Transform(const Matrix& matrix) const;
+
+	static const BoundingSphere FromVertices(const VertexBuffer& vertices, const BoundingBox& bounds);
+};
+
+//
+// The volume a camera can see, as a set of world space planes facing inwards.
+//
+class Frustum
+{
+	//
+	// A plane, points on its inner side have a positive distance.
+	//
+	struct Plane
+	{
+		Vector3 normal;
+		float offset{ 0 };
+
+		inline const float GetDistance(const Vector3& point) const;
+	};
+
+public:
+	//
+	// Extracts the planes from a view-projection matrix, along with the near
+	// plane at the given distance.
+	//
+	void Reset(const Matrix& viewProjection, const float& nearPlane);
+
+	const bool Intersects(const BoundingSphere& sphere) const;
+	const bool Intersects(const BoundingBox& box) const;
+
+	//
+	// Whether the whole box is within the frustum.
+	//
+	const bool Contains(const BoundingBox& box) const;
+
+private:
+	//
+	// Left, right, top and bottom planes, followed by the near plane.
+	//
+	static constexpr int PLANES_COUNT = 5;
+
+	Plane _planes[PLANES_COUNT];
+};
+
+//
+// Signed distance of a point from the plane.
+//
+inline const float Frustum::Plane::GetDistance(const Vector3& point) const
+{
+	return Vector3::Dot(normal, point) + offset;
+}
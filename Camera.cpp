@@ -4,8 +4,9 @@
 #include <math.h>
 #include <cmath>
 
-// Definition for static member
+// Definition for static members
 Camera* Camera::_mainCamera;
+unsigned int Camera::_constantsVersion;
 
 //
 // Default constructor
@@ -33,7 +34,16 @@ Camera::Camera(const Camera& other)
 // The projection matrix, transforms a point from camera space directly into screen
 // space (merges cam2proj and proj2screen matrices into one function call).
 //
-const Matrix Camera::GetProjectionMatrix() const
+const Matrix& Camera::GetProjectionMatrix() const
+{
+	return GetConstants().projection;
+}
+
+//
+// Builds the projection matrix from the field of view, perspective mode and
+// viewport aspect ratio.
+//
+const Matrix Camera::CalculateProjectionMatrix() const
 {
 	Matrix projectionMatrix;
 	float d = 1 / std::tan((_fieldOfView * static_cast<float>(M_PI) / 180.f) / 2);
@@ -91,7 +101,15 @@ const Matrix Camera::GetCameraToWorldMatrix() const
 //
 // Matrix to transform coordinates from projection space to screen space.
 //
-const Matrix Camera::GetProjectionToClipMatrix() const
+const Matrix& Camera::GetProjectionToClipMatrix() const
+{
+	return GetConstants().projectionToClip;
+}
+
+//
+// Builds the projection to clip matrix for the active viewport.
+//
+const Matrix Camera::CalculateProjectionToClipMatrix() const
 {
 	Matrix projectionToScreenMatrix;
 
@@ -116,6 +134,42 @@ const Matrix Camera::GetProjectionToClipMatrix() const
 	return projectionToScreenMatrix;
 }
 
+//
+// Every matrix needed to draw a frame from this camera, rebuilt only when
+// the camera or the viewport changed since they were last requested.
+//
+const CameraConstants& Camera::GetConstants() const
+{
+	const unsigned int width = Bitmap::GetActive()->GetWidth();
+	const unsigned int height = Bitmap::GetActive()->GetHeight();
+
+	if (_isDirty || width != _viewportWidth || height != _viewportHeight)
+	{
+		_constants.view = _worldToCameraMatrix;
+		_constants.projection = CalculateProjectionMatrix();
+		_constants.projectionToClip = CalculateProjectionToClipMatrix();
+		_constants.viewProjection = _constants.projection * _constants.view;
+		_constants.projectionClip = _constants.projectionToClip * _constants.projection;
+		_constants.frustum.Reset(_constants.viewProjection, _nearPlane);
+		_constants.viewClip = _constants.projectionToClip * _constants.viewProjection;
+		_constants.version = ++_constantsVersion;
+
+		_viewportWidth = width;
+		_viewportHeight = height;
+		_isDirty = false;
+	}
+
+	return _constants;
+}
+
+//
+// Flags the cached constants as out of date.
+//
+void Camera::MarkDirty()
+{
+	_isDirty = true;
+}
+
 //
 // The field of view
 //
@@ -130,6 +184,7 @@ const float Camera::GetFieldOfView() const
 void Camera::SetFieldOfView(const float& fieldOfView)
 {
 	_fieldOfView = fieldOfView;
+	MarkDirty();
 }
 
 //
@@ -146,6 +201,24 @@ const bool& Camera::IsPerspective() const
 void Camera::SetPerspective(const bool& toggle)
 {
 	_isPerspective = toggle;
+	MarkDirty();
+}
+
+//
+// Distance of the near clipping plane, nothing closer to the camera is drawn.
+//
+const float& Camera::GetNearPlane() const
+{
+	return _nearPlane;
+}
+
+//
+// Sets the distance of the near clipping plane.
+//
+void Camera::SetNearPlane(const float& distance)
+{
+	_nearPlane = distance;
+	MarkDirty();
 }
 
 //
@@ -161,6 +234,7 @@ void Camera::SetPosition(const Vector3& position)
 	};
 
 	_worldToCameraMatrix = _position * _rotation;
+	MarkDirty();
 }
 
 //
@@ -191,6 +265,7 @@ void Camera::SetRotation(const Vector3& rotation)
 
 	_rotation = rotationX * rotationY * rotationZ;
 	_worldToCameraMatrix = _position * _rotation;
+	MarkDirty();
 }
 
 //
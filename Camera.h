@@ -3,6 +3,25 @@
 #include "Vector.h"
 #include "Bitmap.h"
 #include "Transformable.h"
+#include "Bounds.h"
+
+//
+// Camera matrices shared by every shape drawn in a frame. Only rebuilt once
+// the camera moves, its projection changes, or the viewport is resized.
+//
+struct CameraConstants
+{
+	Matrix view;				// World to camera space.
+	Matrix projection;			// Camera to projection space.
+	Matrix projectionToClip;	// Projection to clip space.
+	Matrix viewProjection;		// View and projection combined.
+	Matrix projectionClip;		// Projection and projection to clip combined.
+
+	Frustum frustum;			// World space volume visible from the camera.
+	Matrix viewClip;			// View, projection and projection to clip combined.
+
+	unsigned int version = 0;	// Changes every time any of the matrices do.
+};
 
 //
 // Scene camera.
@@ -19,7 +38,7 @@ public:
 	//
 	// Matrix to convert from camera space to screen space.
 	//
-	const Matrix GetProjectionMatrix() const;
+	const Matrix& GetProjectionMatrix() const;
 
 	//
 	// Matrices to convert from world to camera space and vice versa.
@@ -30,7 +49,12 @@ public:
 	//
 	// Matrix to convert points from projection space to screen space.
 	//
-	const Matrix GetProjectionToClipMatrix() const;
+	const Matrix& GetProjectionToClipMatrix() const;
+
+	//
+	// Every matrix needed to draw a frame from this camera.
+	//
+	const CameraConstants& GetConstants() const;
 
 	//
 	// Field of view accessors.
@@ -44,6 +68,12 @@ public:
 	const bool& IsPerspective() const;
 	void SetPerspective(const bool& toggle);
 
+	//
+	// Distance of the near clipping plane (perspective only).
+	//
+	const float& GetNearPlane() const;
+	void SetNearPlane(const float& distance);
+
 	//
 	// Allows the camera to be placed in a certain position and rotation
 	//
@@ -62,6 +92,14 @@ public:
 	static Camera* const GetMainCamera();
 	void SetMain();
 
+private:
+	//
+	// Matrix generation, only used when rebuilding the constants.
+	//
+	const Matrix CalculateProjectionMatrix() const;
+	const Matrix CalculateProjectionToClipMatrix() const;
+	void MarkDirty();
+
 private:
 	//
 	// View and screen matrix
@@ -84,5 +122,19 @@ private:
 	//
 	float _fieldOfView = 90.f;
 	bool _isPerspective = true;
+	float _nearPlane = .1f;
+
+	//
+	// Cached matrices, along with the viewport they were built for
+	//
+	mutable CameraConstants _constants;
+	mutable bool _isDirty = true;
+	mutable unsigned int _viewportWidth = 0;
+	mutable unsigned int _viewportHeight = 0;
+
+	//
+	// Last version handed out to any camera's constants
+	//
+	static unsigned int _constantsVersion;
 };
 
@@ -0,0 +1,167 @@
+#include "Clipper.h"
+#include <utility>
+
+//
+// Sets up the clipping planes for the given camera projection (camera to
+// homogeneous clip space), near plane distance and viewport.
+//
+void Clipper::Reset(const Matrix& projection, const float& nearPlane, const FrameBuffer& viewport)
+{
+	_projection = projection;
+	_nearPlane = nearPlane;
+	_width = static_cast<float>(viewport.width);
+	_height = static_cast<float>(viewport.height);
+
+	// w >= near
+	_planes[0] = { 0, 0, 0, 1, -nearPlane };
+
+	// -guard <= x / w <= width + guard
+	_planes[1] = { 1, 0, 0, GUARD_BAND, 0 };
+	_planes[2] = { -1, 0, 0, _width + GUARD_BAND, 0 };
+
+	// -guard <= y / w <= height + guard
+	_planes[3] = { 0, 1, 0, GUARD_BAND, 0 };
+	_planes[4] = { 0, -1, 0, _height + GUARD_BAND, 0 };
+}
+
+//
+// Classifies a triangle from its clip-space vertices, whose depth holds their
+// W component from before they were dehomogenised.
+//
+const Clipper::ClipResult Clipper::Classify(const VertexBuffer& clipSpace, const int& a, const int& b, const int& c) const
+{
+	const float* x = clipSpace.GetX();
+	const float* y = clipSpace.GetY();
+	const float* depth = clipSpace.GetDepth();
+
+	const bool isBehindA = depth[a] < _nearPlane;
+	const bool isBehindB = depth[b] < _nearPlane;
+	const bool isBehindC = depth[c] < _nearPlane;
+
+	// The screen positions of vertices behind the near plane are meaningless,
+	// so anything crossing it has to go through the homogeneous clipper.
+	if (isBehindA && isBehindB && isBehindC)
+	{
+		return ClipResult::CLIP_OUTSIDE;
+	}
+
+	if (isBehindA || isBehindB || isBehindC)
+	{
+		return ClipResult::CLIP_CLIPPED;
+	}
+
+	const float left = min(x[a], min(x[b], x[c]));
+	const float right = max(x[a], max(x[b], x[c]));
+	const float top = min(y[a], min(y[b], y[c]));
+	const float bottom = max(y[a], max(y[b], y[c]));
+
+	if (right < 0 || left >= _width || bottom < 0 || top >= _height)
+	{
+		return ClipResult::CLIP_OUTSIDE;
+	}
+
+	if (left < -GUARD_BAND || right > _width + GUARD_BAND || top < -GUARD_BAND || bottom > _height + GUARD_BAND)
+	{
+		return ClipResult::CLIP_CLIPPED;
+	}
+
+	return ClipResult::CLIP_INSIDE;
+}
+
+//
+// Clips a triangle against the near plane and the guard band, one plane at a
+// time (Sutherland-Hodgman). New vertices are interpolated in homogeneous
+// space, along with their attributes and world-space counterparts, and only
+// dehomogenised once every plane has been dealt with.
+//
+const int Clipper::Clip(const Vertex (&clipSpace)[3], const Vertex (&worldSpace)[3], ClippedPolygon& polygon) const
+{
+	ClippedPolygon buffer;
+
+	Vertex homogeneous[MAX_CLIPPED_VERTICES];
+	Vertex bufferHomogeneous[MAX_CLIPPED_VERTICES];
+
+	for (int i = 0; i < 3; ++i)
+	{
+		polygon.clipSpace[i] = clipSpace[i];
+		polygon.worldSpace[i] = worldSpace[i];
+		homogeneous[i] = _projection * worldSpace[i];
+	}
+
+	polygon.count = 3;
+
+	ClippedPolygon* source = &polygon;
+	ClippedPolygon* target = &buffer;
+
+	Vertex(*sourceHomogeneous)[MAX_CLIPPED_VERTICES] = &homogeneous;
+	Vertex(*targetHomogeneous)[MAX_CLIPPED_VERTICES] = &bufferHomogeneous;
+
+	for (const Plane& plane : _planes)
+	{
+		if (ClipAgainstPlane(plane, *source, *sourceHomogeneous, *target, *targetHomogeneous) < 3)
+		{
+			polygon.count = 0;
+			return 0;
+		}
+
+		std::swap(source, target);
+		std::swap(sourceHomogeneous, targetHomogeneous);
+	}
+
+	if (source != &polygon)
+	{
+		polygon = *source;
+	}
+
+	for (int i = 0; i < polygon.count; ++i)
+	{
+		const Vertex& point = (*sourceHomogeneous)[i];
+		Vertex& vertex = polygon.clipSpace[i];
+
+		vertex.SetX(point.GetX() / point.GetW());
+		vertex.SetY(point.GetY() / point.GetW());
+		vertex.SetZ(point.GetZ() / point.GetW());
+		vertex.SetW(1); /* w/w = 1 */
+		vertex.SetDepth(point.GetW());
+	}
+
+	return polygon.count;
+}
+
+//
+// Keeps the part of the source polygon on the inner side of the plane,
+// writing it into the target polygon. Returns the amount of vertices kept.
+//
+const int Clipper::ClipAgainstPlane(const Plane& plane, const ClippedPolygon& source, const Vertex (&sourceHomogeneous)[MAX_CLIPPED_VERTICES], ClippedPolygon& target, Vertex (&targetHomogeneous)[MAX_CLIPPED_VERTICES])
+{
+	target.count = 0;
+
+	for (int i = 0; i < source.count; ++i)
+	{
+		const int next = (i + 1) % source.count;
+
+		const float distance = plane.GetDistance(sourceHomogeneous[i]);
+		const float nextDistance = plane.GetDistance(sourceHomogeneous[next]);
+
+		if (distance >= 0)
+		{
+			target.clipSpace[target.count] = source.clipSpace[i];
+			target.worldSpace[target.count] = source.worldSpace[i];
+			targetHomogeneous[target.count] = sourceHomogeneous[i];
+			++target.count;
+		}
+
+		// The edge crosses the plane, add the point where it does.
+		if ((distance >= 0) != (nextDistance >= 0))
+		{
+			const float alpha = distance / (distance - nextDistance);
+
+			target.clipSpace[target.count] = Vertex::Lerp(source.clipSpace[i], source.clipSpace[next], alpha);
+			target.worldSpace[target.count] = Vertex::Lerp(source.worldSpace[i], source.worldSpace[next], alpha);
+			targetHomogeneous[target.count] = Vertex::Lerp(sourceHomogeneous[i], sourceHomogeneous[next], alpha);
+			++target.count;
+		}
+	}
+
+	return target.count;
+}
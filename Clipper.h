@@ -0,0 +1,103 @@
+#pragma once
+#include "Vertex.h"
+#include "VertexBuffer.h"
+#include "Matrix.h"
+#include "FrameBuffer.h"
+
+//
+// Distance (in pixels) triangles may reach past the edges of the viewport
+// before they are clipped in X and Y. Anything within it is left to the
+// rasterisers, which never walk pixels outside their clip rectangle.
+//
+constexpr float GUARD_BAND = 1024.f;
+
+//
+// Largest amount of vertices a clipped triangle can have (each of the five
+// clipping planes adds at most one).
+//
+constexpr int MAX_CLIPPED_VERTICES = 8;
+
+//
+// A triangle after clipping: a convex polygon, drawn as a fan of triangles
+// around its first vertex.
+//
+struct ClippedPolygon
+{
+	Vertex clipSpace[MAX_CLIPPED_VERTICES];
+	Vertex worldSpace[MAX_CLIPPED_VERTICES];
+	int count{ 0 };
+};
+
+//
+// Clipping stage between the vertex transform and the rasterisers. Triangles
+// crossing the camera's near plane, or reaching past the guard band, are
+// clipped in homogeneous space, where their vertices are still well defined.
+// Triangles entirely outside the viewport are rejected outright.
+//
+class Clipper
+{
+public:
+	//
+	// What has to be done with a triangle.
+	//
+	enum class ClipResult
+	{
+		CLIP_INSIDE,	// Can be rasterised as it is.
+		CLIP_OUTSIDE,	// Covers no pixel, can be skipped.
+		CLIP_CLIPPED	// Has to be clipped first.
+	};
+
+	void Reset(const Matrix& projection, const float& nearPlane, const FrameBuffer& viewport);
+
+	//
+	// Classifies a triangle from the indices of its (dehomogenised) clip-space
+	// vertices.
+	//
+	const ClipResult Classify(const VertexBuffer& clipSpace, const int& a, const int& b, const int& c) const;
+
+	//
+	// Clips a triangle, given by its clip and world (camera) space vertices,
+	// against the near plane and the guard band. Returns the amount of vertices
+	// left, fewer than three means nothing is left to draw.
+	//
+	const int Clip(const Vertex (&clipSpace)[3], const Vertex (&worldSpace)[3], ClippedPolygon& polygon) const;
+
+private:
+	//
+	// A clipping plane, in homogeneous space. A point is kept when its distance
+	// (x * X + y * Y + z * Z + w * W + offset) is not negative.
+	//
+	struct Plane
+	{
+		float x{ 0 };
+		float y{ 0 };
+		float z{ 0 };
+		float w{ 0 };
+		float offset{ 0 };
+
+		inline const float GetDistance(const Vertex& point) const;
+	};
+
+	static const int ClipAgainstPlane(const Plane& plane, const ClippedPolygon& source, const Vertex (&sourceHomogeneous)[MAX_CLIPPED_VERTICES], ClippedPolygon& target, Vertex (&targetHomogeneous)[MAX_CLIPPED_VERTICES]);
+
+private:
+	//
+	// Near plane, followed by the guard band edges.
+	//
+	static constexpr int PLANES_COUNT = 5;
+
+	Matrix _projection;				// Camera to (homogeneous) clip space.
+	Plane _planes[PLANES_COUNT];
+
+	float _nearPlane{ 0 };
+	float _width{ 0 };
+	float _height{ 0 };
+};
+
+//
+// Signed distance of a homogeneous point from the plane.
+//
+inline const float Clipper::Plane::GetDistance(const Vertex& point) const
+{
+	return x * point.GetX() + y * point.GetY() + z * point.GetZ() + w * point.GetW() + offset;
+}
@@ -250,6 +250,14 @@ Colour Colour::FromColor(const COLORREF& rhs)
 	return Colour(GetRValue(rhs) / 255.f, GetGValue(rhs) / 255.f, GetBValue(rhs) / 255.f);
 }
 
+//
+// Creates a colour from a frame buffer pixel (0x00RRGGBB).
+//
+Colour Colour::FromPixel(const UINT32& pixel)
+{
+	return Colour(((pixel >> 16) & 0xFF) / 255.f, ((pixel >> 8) & 0xFF) / 255.f, (pixel & 0xFF) / 255.f);
+}
+
 //
 // Converts this colour to a COLORREF struct instance.
 //
@@ -37,6 +37,7 @@ public:
 	const bool operator==(const Colour& rhs) const;
 
 	static Colour FromColor(const COLORREF& rhs);
+	static Colour FromPixel(const UINT32& pixel);
 	const COLORREF AsColor() const;
 
 	static Colour Lerp(const Colour& lhs, const Colour& rhs, const float& alpha);
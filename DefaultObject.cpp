@@ -25,6 +25,8 @@ void DefaultObject::OnInit()
 	_demo = Environment::GetActive().CreateObject<SimpleDemo>("Presentation").get();
 #elif DEMO_TYPE == MODE_PRESENTATION
 	_demo = Environment::GetActive().CreateObject<Presentation>("Presentation").get();
+#elif DEMO_TYPE == MODE_BENCHMARK
+	_demo = Environment::GetActive().CreateObject<Benchmark>("Benchmark").get();
 #endif
 }
 
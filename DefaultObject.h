@@ -8,6 +8,7 @@
 
 #define MODE_SIMPLE 0xFF
 #define MODE_PRESENTATION 0xFE
+#define MODE_BENCHMARK 0xFD
 
 // ------
 #define DEMO_TYPE MODE_PRESENTATION	// Defines which kind of demo will play
@@ -17,6 +18,8 @@
 #include "SimpleDemo.h"
 #elif DEMO_TYPE == MODE_PRESENTATION
 #include "Presentation.h"
+#elif DEMO_TYPE == MODE_BENCHMARK
+#include "Benchmark.h"
 #endif
 
 //
@@ -34,6 +37,8 @@ private:
 	SimpleDemo* _demo;
 #elif DEMO_TYPE == MODE_PRESENTATION
 	Presentation* _demo;
+#elif DEMO_TYPE == MODE_BENCHMARK
+	Benchmark* _demo;
 #endif
 };
 
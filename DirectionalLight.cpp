@@ -13,7 +13,7 @@ DirectionalLight::DirectionalLight() : Light()
 //
 // Creates a directional light with a custom orientation.
 //
-DirectionalLight::DirectionalLight(Vector3 direction) : _direction(direction)
+DirectionalLight::DirectionalLight(Vector3 direction) : _direction(Vector3::NormaliseVector(direction))
 { }
 
 //
@@ -55,3 +55,11 @@ Colour DirectionalLight::CalculateContribution(const Vertex& position, const Vec
 	
 	return GetIntensity() * lightValue * phongHighlights;
 }
+
+//
+// Adds the light to the directional light arrays of a packed light buffer.
+//
+void DirectionalLight::Pack(LightBuffer& buffer)
+{
+	buffer.AddDirectional(GetIntensity(), _direction);
+}
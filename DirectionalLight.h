@@ -16,6 +16,11 @@ public:
 
 	Colour CalculateContribution(const Vertex& position, const Vector3& normal, const Colour& ambient, const float& roughness, const float& specular) override;
 
+	//
+	// Adds the light to the directional light arrays of a packed light buffer.
+	//
+	void Pack(LightBuffer& buffer) override;
+
 private:
 	Vector3 _direction;
 };
@@ -1,4 +1,6 @@
 #include "Environment.h"
+#include "Camera.h"
+#include "Bitmap.h"
 #include <algorithm>
 
 //
@@ -42,6 +44,10 @@ const Environment& Environment::operator=(Environment& rhs)
 		_sceneObjects.push_back(std::move(so));
 	}
 
+	// The objects are added to the tree again when the scene is next rendered.
+	_sceneTree.Clear();
+	_sceneNodes.assign(_sceneObjects.size(), SceneTree::NULL_NODE);
+
 	return *this;
 }
 
@@ -62,6 +68,15 @@ const bool Environment::DeleteObject(SceneObjectPtr& sceneObject)
 	}
 
 	(*obj_ptr)->OnDelete();
+
+	const auto node_ptr = _sceneNodes.begin() + (obj_ptr - _sceneObjects.begin());
+
+	if (*node_ptr != SceneTree::NULL_NODE)
+	{
+		_sceneTree.Remove(*node_ptr);
+	}
+
+	_sceneNodes.erase(node_ptr);
 	_sceneObjects.erase(obj_ptr);
 
 	return true;
@@ -96,6 +111,40 @@ const std::vector<std::shared_ptr<Light>>& Environment::GetSceneLights() const
 	return _sceneLights;
 }
 
+//
+// The lights binned into screen tiles for the frame being rendered.
+//
+const LightGrid& Environment::GetLightGrid() const
+{
+	return _lightGrid;
+}
+
+//
+// Pixels of deferred meshes waiting to be lit.
+//
+GBuffer& Environment::GetGBuffer()
+{
+	return _gbuffer;
+}
+
+//
+// Finds every object whose bounds overlap the volume.
+//
+void Environment::FindObjects(const BoundingSphere& volume, std::vector<SceneObject*>& objects) const
+{
+	_sceneTree.Query(volume, objects);
+}
+
+//
+// The closest object whose bounds are hit by the ray, or null if none are.
+//
+SceneObject* const Environment::Pick(const Vector3& origin, const Vector3& direction) const
+{
+	float distance = 0;
+
+	return _sceneTree.Raycast(origin, direction, distance);
+}
+
 //
 // Called upon initialisation.
 //
@@ -119,14 +168,83 @@ void Environment::OnTick(const float& deltaTime)
 }
 
 //
-// Called when rendering is requested.
+// Called when rendering is requested. Only objects the main camera can see are
+// drawn, as found by the scene tree, along with those that cannot be bounded.
+// Lights are binned into screen tiles once, before anything is drawn, and the
+// pixels of deferred meshes are lit once everything has been.
 //
 void Environment::OnRender(const HDC& hdc)
 {
-	for (auto& sceneObject : _sceneObjects)
+	UpdateSceneTree();
+
+	const FrameBuffer& target = Bitmap::GetActive()->GetFrameBuffer();
+	const Camera* const mainCamera = Camera::GetMainCamera();
+
+	_gbuffer.Reset(target);
+
+	if (mainCamera)
+	{
+		const CameraConstants& constants = mainCamera->GetConstants();
+
+		_sceneTree.Query(constants.frustum, _renderObjects);
+		_lightGrid.Reset(target, mainCamera->GetPosition(), constants.projectionClip, mainCamera->GetNearPlane(), _sceneLights);
+	}
+	else
+	{
+		// Without a camera nothing can be culled.
+		_renderObjects.clear();
+
+		for (auto& sceneObject : _sceneObjects)
+		{
+			_renderObjects.push_back(sceneObject.get());
+		}
+	}
+
+	for (SceneObject* const sceneObject : _renderObjects)
 	{
 		sceneObject->Render(hdc);
 	}
+
+	if (mainCamera)
+	{
+		_gbuffer.Resolve(target, _lightGrid, mainCamera->GetConstants().projectionClip);
+	}
+}
+
+//
+// Brings the scene tree up to date with the bounds of every object. Objects
+// that stay within their leaf leave the tree untouched.
+//
+void Environment::UpdateSceneTree()
+{
+	_renderObjects.clear();
+
+	for (size_t i = 0; i < _sceneObjects.size(); ++i)
+	{
+		SceneObject* const sceneObject = _sceneObjects[i].get();
+		int& node = _sceneNodes[i];
+
+		BoundingBox bounds;
+
+		if (!sceneObject->GetWorldBounds(bounds))
+		{
+			if (node != SceneTree::NULL_NODE)
+			{
+				_sceneTree.Remove(node);
+				node = SceneTree::NULL_NODE;
+			}
+
+			_renderObjects.push_back(sceneObject);
+		}
+		else if (node == SceneTree::NULL_NODE)
+		{
+			node = _sceneTree.Insert(sceneObject, bounds);
+		}
+		else
+		{
+			_sceneTree.Move(node, bounds);
+		}
+	}
 }
 
 //
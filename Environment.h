@@ -2,6 +2,9 @@
 #include "Shape.h"
 #include "Light.h"
 #include "SceneObject.h"
+#include "SceneTree.h"
+#include "LightGrid.h"
+#include "GBuffer.h"
 #include <vector>
 #include <string>
 #include <type_traits>
@@ -33,6 +36,23 @@ public:
 
 	const std::vector<LightPtr>& GetSceneLights() const;
 
+	//
+	// The lights binned into screen tiles for the frame being rendered.
+	//
+	const LightGrid& GetLightGrid() const;
+
+	//
+	// Pixels of deferred meshes waiting to be lit, once every object is drawn.
+	//
+	GBuffer& GetGBuffer();
+
+	//
+	// Scene queries, answered from the bounds the objects had when the scene
+	// was last rendered. Objects that cannot be bounded are never found.
+	//
+	void FindObjects(const BoundingSphere& volume, std::vector<SceneObject*>& objects) const;	// e.g. objects within the reach of a light.
+	SceneObject* const Pick(const Vector3& origin, const Vector3& direction) const;			// Closest object along a ray.
+
 	void OnStart();
 	void OnTick(const float& deltaTime);
 	void OnRender(const HDC& hdc);
@@ -42,12 +62,26 @@ public:
 
 	static Environment& GetActive();
 
+private:
+	//
+	// Brings the scene tree up to date with the bounds of every object, and
+	// lists the objects that cannot be bounded.
+	//
+	void UpdateSceneTree();
+
 private:
 	static Environment* _activeEnvironment;
 
 	std::vector<SceneObjectPtr> _sceneObjects;
 	std::vector<LightPtr> _sceneLights;
 
+	SceneTree _sceneTree;
+	std::vector<int> _sceneNodes;				// Tree leaf of each scene object, in the same order.
+	std::vector<SceneObject*> _renderObjects;	// Objects to draw this frame.
+
+	LightGrid _lightGrid;
+	GBuffer _gbuffer;
+
 	// Colours
 	COLORREF _background = RGB(0x75, 0x75, 0x75);
 };
@@ -64,6 +98,7 @@ inline std::shared_ptr<TObjType> Environment::CreateObject(const std::string& ob
 	}
 
 	_sceneObjects.push_back(std::make_shared<TObjType>());
+	_sceneNodes.push_back(SceneTree::NULL_NODE);
 	std::shared_ptr<TObjType> created = std::dynamic_pointer_cast<TObjType>(_sceneObjects.back());
 
 	// OnInit...
@@ -0,0 +1,166 @@
+#pragma once
+#include <emmintrin.h>
+#include "Vector.h"
+#include "Colour.h"
+
+//
+// Amount of fragments shaded together by the vectorised (SSE) shading path.
+//
+constexpr int FRAGMENT_BLOCK_SIZE = 4;
+
+//
+// Four vectors, stored as a structure of arrays (one SSE register per axis).
+//
+struct Vector3Block
+{
+	__m128 x;
+	__m128 y;
+	__m128 z;
+
+	//
+	// The same vector on every lane.
+	//
+	static inline Vector3Block Broadcast(const Vector3& vector);
+
+	//
+	// Vector aritmetics, performed on every lane.
+	//
+	static inline Vector3Block Add(const Vector3Block& lhs, const Vector3Block& rhs);
+	static inline Vector3Block Subtract(const Vector3Block& lhs, const Vector3Block& rhs);
+	static inline Vector3Block Scale(const Vector3Block& vector, const __m128& scale);
+	static inline __m128 Dot(const Vector3Block& lhs, const Vector3Block& rhs);
+	static inline __m128 GetMagnitude(const Vector3Block& vector);
+	static inline Vector3Block NormaliseVector(const Vector3Block& vector);
+};
+
+//
+// Four colours, stored as a structure of arrays. Just like Colour, the
+// operations clamp every channel between 0 and 1.
+//
+struct ColourBlock
+{
+	__m128 red;
+	__m128 green;
+	__m128 blue;
+
+	//
+	// The same colour on every lane.
+	//
+	static inline ColourBlock Broadcast(const Colour& colour);
+
+	//
+	// Clamped colour aritmetics, performed on every lane.
+	//
+	static inline ColourBlock Add(const ColourBlock& lhs, const ColourBlock& rhs);
+	static inline ColourBlock Multiply(const ColourBlock& lhs, const ColourBlock& rhs);
+	static inline ColourBlock Multiply(const ColourBlock& lhs, const __m128& rhs);
+	static inline __m128 Clamp(const __m128& value);
+};
+
+//
+// The shading inputs of four fragments: their (world) positions and normals.
+//
+struct FragmentBlock
+{
+	Vector3Block position;
+	Vector3Block normal;
+};
+
+//
+// The same vector on every lane.
+//
+inline Vector3Block Vector3Block::Broadcast(const Vector3& vector)
+{
+	return { _mm_set1_ps(vector.GetX()), _mm_set1_ps(vector.GetY()), _mm_set1_ps(vector.GetZ()) };
+}
+
+//
+// Adds two vectors together.
+//
+inline Vector3Block Vector3Block::Add(const Vector3Block& lhs, const Vector3Block& rhs)
+{
+	return { _mm_add_ps(lhs.x, rhs.x), _mm_add_ps(lhs.y, rhs.y), _mm_add_ps(lhs.z, rhs.z) };
+}
+
+//
+// Subtracts a vector from another.
+//
+inline Vector3Block Vector3Block::Subtract(const Vector3Block& lhs, const Vector3Block& rhs)
+{
+	return { _mm_sub_ps(lhs.x, rhs.x), _mm_sub_ps(lhs.y, rhs.y), _mm_sub_ps(lhs.z, rhs.z) };
+}
+
+//
+// Multiplies every axis of a vector by a scalar.
+//
+inline Vector3Block Vector3Block::Scale(const Vector3Block& vector, const __m128& scale)
+{
+	return { _mm_mul_ps(vector.x, scale), _mm_mul_ps(vector.y, scale), _mm_mul_ps(vector.z, scale) };
+}
+
+//
+// Dot product of two vectors.
+//
+inline __m128 Vector3Block::Dot(const Vector3Block& lhs, const Vector3Block& rhs)
+{
+	return _mm_add_ps(_mm_add_ps(_mm_mul_ps(lhs.x, rhs.x), _mm_mul_ps(lhs.y, rhs.y)), _mm_mul_ps(lhs.z, rhs.z));
+}
+
+//
+// The magnitude (length) of the vectors.
+//
+inline __m128 Vector3Block::GetMagnitude(const Vector3Block& vector)
+{
+	return _mm_sqrt_ps(Dot(vector, vector));
+}
+
+//
+// Normalises the vectors. This is a full division, rather than a reciprocal
+// square root estimate, so that it matches Vector3::NormaliseVector.
+//
+inline Vector3Block Vector3Block::NormaliseVector(const Vector3Block& vector)
+{
+	const __m128 magnitude = GetMagnitude(vector);
+
+	return { _mm_div_ps(vector.x, magnitude), _mm_div_ps(vector.y, magnitude), _mm_div_ps(vector.z, magnitude) };
+}
+
+//
+// The same colour on every lane.
+//
+inline ColourBlock ColourBlock::Broadcast(const Colour& colour)
+{
+	return { _mm_set1_ps(colour.GetRed()), _mm_set1_ps(colour.GetGreen()), _mm_set1_ps(colour.GetBlue()) };
+}
+
+//
+// Addition operator.
+//
+inline ColourBlock ColourBlock::Add(const ColourBlock& lhs, const ColourBlock& rhs)
+{
+	return { Clamp(_mm_add_ps(lhs.red, rhs.red)), Clamp(_mm_add_ps(lhs.green, rhs.green)), Clamp(_mm_add_ps(lhs.blue, rhs.blue)) };
+}
+
+//
+// Multiplication operator.
+//
+inline ColourBlock ColourBlock::Multiply(const ColourBlock& lhs, const ColourBlock& rhs)
+{
+	return { Clamp(_mm_mul_ps(lhs.red, rhs.red)), Clamp(_mm_mul_ps(lhs.green, rhs.green)), Clamp(_mm_mul_ps(lhs.blue, rhs.blue)) };
+}
+
+//
+// Multiplies a colour by a scalar.
+//
+inline ColourBlock ColourBlock::Multiply(const ColourBlock& lhs, const __m128& rhs)
+{
+	return { Clamp(_mm_mul_ps(lhs.red, rhs)), Clamp(_mm_mul_ps(lhs.green, rhs)), Clamp(_mm_mul_ps(lhs.blue, rhs)) };
+}
+
+//
+// Clamps a value between 0 and 1.
+//
+inline __m128 ColourBlock::Clamp(const __m128& value)
+{
+	return _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.f));
+}
@@ -0,0 +1,79 @@
+#include "FragmentFunction.h"
+#include <cmath>
+
+//
+// Fills the attribute arrays of the listed pixels. Every attribute is
+// interpolated in its own plain loop, so that the compiler is free to
+// vectorise them.
+//
+void FragmentSpan::Interpolate(const FragmentGradients& gradients)
+{
+	const int padded = GetPaddedCount();
+
+	for (int i = count; i < padded; ++i)
+	{
+		offsets[i] = offsets[count - 1];
+	}
+
+	float positions[FRAGMENT_SPAN_LENGTH];
+
+	for (int i = 0; i < padded; ++i)
+	{
+		positions[i] = static_cast<float>(offsets[i]);
+	}
+
+	Interpolate(worldX, gradients.world.GetX(), gradients.worldStep.GetX(), positions, padded);
+	Interpolate(worldY, gradients.world.GetY(), gradients.worldStep.GetY(), positions, padded);
+	Interpolate(worldZ, gradients.world.GetZ(), gradients.worldStep.GetZ(), positions, padded);
+
+	Interpolate(normalX, gradients.normal.GetX(), gradients.normalStep.GetX(), positions, padded);
+	Interpolate(normalY, gradients.normal.GetY(), gradients.normalStep.GetY(), positions, padded);
+	Interpolate(normalZ, gradients.normal.GetZ(), gradients.normalStep.GetZ(), positions, padded);
+
+	// Arrays are padded to whole blocks, normals are normalised a block at a time.
+	for (int i = 0; i < padded; i += FRAGMENT_BLOCK_SIZE)
+	{
+		const Vector3Block normal = Vector3Block::NormaliseVector({ _mm_loadu_ps(normalX + i), _mm_loadu_ps(normalY + i), _mm_loadu_ps(normalZ + i) });
+
+		_mm_storeu_ps(normalX + i, normal.x);
+		_mm_storeu_ps(normalY + i, normal.y);
+		_mm_storeu_ps(normalZ + i, normal.z);
+	}
+
+	float inverseDepths[FRAGMENT_SPAN_LENGTH];
+
+	Interpolate(u, gradients.uv.GetX(), gradients.uvStep.GetX(), positions, padded);
+	Interpolate(v, gradients.uv.GetY(), gradients.uvStep.GetY(), positions, padded);
+	Interpolate(inverseDepths, gradients.uv.GetZ(), gradients.uvStep.GetZ(), positions, padded);
+
+	for (int i = 0; i < padded; i += FRAGMENT_BLOCK_SIZE)
+	{
+		const __m128 inverseDepth = _mm_loadu_ps(inverseDepths + i);
+
+		_mm_storeu_ps(u + i, _mm_div_ps(_mm_loadu_ps(u + i), inverseDepth));
+		_mm_storeu_ps(v + i, _mm_div_ps(_mm_loadu_ps(v + i), inverseDepth));
+	}
+
+	// Derivative of the perspective divide along the span, which textures
+	// pick their level of detail from.
+	const float middle = (positions[0] + positions[count - 1]) * .5f;
+	const float depth = gradients.uv.GetZ() + gradients.uvStep.GetZ() * middle;
+	const float uOverDepth = gradients.uv.GetX() + gradients.uvStep.GetX() * middle;
+	const float vOverDepth = gradients.uv.GetY() + gradients.uvStep.GetY() * middle;
+
+	const float du = (gradients.uvStep.GetX() * depth - uOverDepth * gradients.uvStep.GetZ()) / (depth * depth);
+	const float dv = (gradients.uvStep.GetY() * depth - vOverDepth * gradients.uvStep.GetZ()) / (depth * depth);
+
+	texelFootprint = std::sqrt(du * du + dv * dv);
+}
+
+//
+// Interpolates a single attribute linearly along the span.
+//
+void FragmentSpan::Interpolate(float* values, const float& source, const float& step, const float* offsets, const int& count)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		values[i] = source + step * offsets[i];
+	}
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <Windows.h>
+#include "Vector.h"
+#include "FragmentBlock.h"
+
+//
+// Maximum amount of pixels a rasteriser hands to a fragment function at once.
+// Always a multiple of the fragment block size.
+//
+constexpr int FRAGMENT_SPAN_LENGTH = 64;
+
+//
+// Attributes at the first pixel of a span, along with their change for one
+// pixel right, as the rasterisers produce them. UVs are divided by depth,
+// with 1 / depth itself held in Z.
+//
+struct FragmentGradients
+{
+	Vector3 world;
+	Vector3 worldStep;
+
+	Vector3 normal;
+	Vector3 normalStep;
+
+	Vector3 uv;
+	Vector3 uvStep;
+};
+
+//
+// A run of pixels on a single line which passed the depth test, with their
+// interpolated attributes stored as arrays (normals already normalised, UVs
+// already perspective corrected).
+//
+// Arrays are padded up to a whole amount of fragment blocks by repeating the
+// last pixel, so that they can always be read a block at a time.
+//
+struct FragmentSpan
+{
+	int offsets[FRAGMENT_SPAN_LENGTH];	// From the first pixel of the span, ascending.
+	int count{ 0 };
+
+	int x{ 0 };		// Screen position of the first pixel of the span.
+	int y{ 0 };
+
+	float worldX[FRAGMENT_SPAN_LENGTH];
+	float worldY[FRAGMENT_SPAN_LENGTH];
+	float worldZ[FRAGMENT_SPAN_LENGTH];
+
+	float normalX[FRAGMENT_SPAN_LENGTH];
+	float normalY[FRAGMENT_SPAN_LENGTH];
+	float normalZ[FRAGMENT_SPAN_LENGTH];
+
+	float u[FRAGMENT_SPAN_LENGTH];
+	float v[FRAGMENT_SPAN_LENGTH];
+
+	float texelFootprint{ 0 };	// Texels the UVs move by from one pixel to the next, in the middle of the span.
+
+	//
+	// Fills the attribute arrays of the listed pixels from the gradients.
+	//
+	void Interpolate(const FragmentGradients& gradients);
+
+	//
+	// Count rounded up to a whole amount of fragment blocks.
+	//
+	const int GetPaddedCount() const;
+
+private:
+	static void Interpolate(float* values, const float& source, const float& step, const float* offsets, const int& count);
+};
+
+//
+// Represents a fragment function handler. Shades whole spans at once, writing
+// packed pixels into a row which starts at the span's first pixel.
+//
+struct FragmentFunction
+{
+	virtual void Shade(const FragmentSpan& span, UINT32* row) const = 0;
+};
+
+//
+// Count rounded up to a whole amount of fragment blocks.
+//
+inline const int FragmentSpan::GetPaddedCount() const
+{
+	return (count + FRAGMENT_BLOCK_SIZE - 1) / FRAGMENT_BLOCK_SIZE * FRAGMENT_BLOCK_SIZE;
+}
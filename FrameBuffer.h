@@ -0,0 +1,87 @@
+#pragma once
+#include <Windows.h>
+
+//
+// Raw view over a 32-bit colour buffer (0x00RRGGBB, top-down rows) that
+// the rasteriser can write into directly without going through GDI, along
+// with its matching depth buffer.
+//
+// Depth is stored as 1/w, so that it can be interpolated linearly in screen
+// space; a cleared buffer holds 0 (infinitely far) and larger values are closer.
+//
+// The rasteriser only ever writes within the clip rectangle, which lets
+// several threads render disjoint regions of the same buffer at once.
+//
+struct FrameBuffer
+{
+	UINT32* pixels{ nullptr };
+	float* depth{ nullptr };
+	int width{ 0 };
+	int height{ 0 };
+
+	// Writable region, right and bottom are exclusive.
+	int clipLeft{ 0 };
+	int clipTop{ 0 };
+	int clipRight{ 0 };
+	int clipBottom{ 0 };
+
+	inline UINT32* GetRow(const int& y) const;
+	inline float* GetDepthRow(const int& y) const;
+
+	inline FrameBuffer GetRegion(const int& left, const int& top, const int& right, const int& bottom) const;
+
+	static inline UINT32 Pack(const float& red, const float& green, const float& blue);
+	static inline UINT32 FromColorRef(const COLORREF& colour);
+};
+
+//
+// The first pixel of the given row.
+//
+inline UINT32* FrameBuffer::GetRow(const int& y) const
+{
+	return pixels + static_cast<size_t>(y) * width;
+}
+
+//
+// The first depth value of the given row.
+//
+inline float* FrameBuffer::GetDepthRow(const int& y) const
+{
+	return depth + static_cast<size_t>(y) * width;
+}
+
+//
+// A view over the same buffers whose clip rectangle is restricted to the
+// given region (clamped to the current one).
+//
+inline FrameBuffer FrameBuffer::GetRegion(const int& left, const int& top, const int& right, const int& bottom) const
+{
+	FrameBuffer region(*this);
+
+	region.clipLeft = max(left, clipLeft);
+	region.clipTop = max(top, clipTop);
+	region.clipRight = min(right, clipRight);
+	region.clipBottom = min(bottom, clipBottom);
+
+	return region;
+}
+
+//
+// Packs a [0, 1] colour into a single pixel value.
+//
+inline UINT32 FrameBuffer::Pack(const float& red, const float& green, const float& blue)
+{
+	return (static_cast<UINT32>(static_cast<BYTE>(red * 255)) << 16) |
+		   (static_cast<UINT32>(static_cast<BYTE>(green * 255)) << 8) |
+		    static_cast<UINT32>(static_cast<BYTE>(blue * 255));
+}
+
+//
+// Converts a GDI colour (0x00BBGGRR) into a pixel value.
+//
+inline UINT32 FrameBuffer::FromColorRef(const COLORREF& colour)
+{
+	return (static_cast<UINT32>(GetRValue(colour)) << 16) |
+		   (static_cast<UINT32>(GetGValue(colour)) << 8) |
+		    static_cast<UINT32>(GetBValue(colour));
+}
@@ -0,0 +1,178 @@
+#include "GBuffer.h"
+#include "ThreadPool.h"
+#include "FragmentBlock.h"
+#include <algorithm>
+#include <emmintrin.h>
+
+//
+// Forgets every pixel and material. The buffers themselves are only cleared
+// once a deferred mesh registers its material, so frames without any cost
+// nothing.
+//
+void GBuffer::Reset(const FrameBuffer& target)
+{
+	_width = target.width;
+	_height = target.height;
+
+	_materialTable.clear();
+}
+
+//
+// Registers the material of a mesh for the frame.
+//
+const int GBuffer::AddMaterial(const GBufferMaterial& material)
+{
+	if (_materialTable.empty())
+	{
+		const size_t size = static_cast<size_t>(_width) * _height;
+
+		_depth.assign(size, 0.f);
+		_normals.resize(size);
+		_albedo.resize(size);
+		_materials.resize(size);
+	}
+
+	_materialTable.push_back(material);
+
+	return static_cast<int>(_materialTable.size() - 1);
+}
+
+//
+// Lights every recorded pixel which is still visible, one row per task.
+//
+void GBuffer::Resolve(const FrameBuffer& target, const LightGrid& lights, const Matrix& projection)
+{
+	if (_materialTable.empty())
+	{
+		return;
+	}
+
+	_projection = projection;
+
+	const float determinant = projection.GetM(0, 0) * projection.GetM(1, 1) - projection.GetM(0, 1) * projection.GetM(1, 0);
+
+	if (determinant == 0)
+	{
+		return;
+	}
+
+	_inverse[0][0] = projection.GetM(1, 1) / determinant;
+	_inverse[0][1] = -projection.GetM(0, 1) / determinant;
+	_inverse[1][0] = -projection.GetM(1, 0) / determinant;
+	_inverse[1][1] = projection.GetM(0, 0) / determinant;
+
+	ThreadPool::Get().ParallelFor(static_cast<size_t>(_height), [&](const size_t& index)
+	{
+		ResolveRow(target, lights, static_cast<int>(index));
+	});
+}
+
+//
+// Lights the visible pixels of a row, a light tile at a time. Consecutive
+// pixels sharing a material are gathered into blocks, so that they can be
+// lit together.
+//
+void GBuffer::ResolveRow(const FrameBuffer& target, const LightGrid& lights, const int& y) const
+{
+	UINT32* row = target.GetRow(y);
+	const float* depthRow = target.GetDepthRow(y);
+
+	const size_t rowStart = static_cast<size_t>(y) * _width;
+
+	for (int tileX = 0; tileX < _width; tileX += LIGHT_TILE_SIZE)
+	{
+		const LightBuffer& tileLights = lights.GetLights(tileX, y);
+		const int tileEnd = min(tileX + LIGHT_TILE_SIZE, _width);
+
+		int columns[FRAGMENT_BLOCK_SIZE];
+		int count = 0;
+		int material = NO_MATERIAL;
+
+		for (int x = tileX; x < tileEnd; ++x)
+		{
+			const float depth = _depth[rowStart + x];
+
+			// Not written by a deferred mesh, or drawn over since.
+			if (depth == 0 || depth != depthRow[x])
+			{
+				continue;
+			}
+
+			const int pixelMaterial = _materials[rowStart + x];
+
+			if (count == FRAGMENT_BLOCK_SIZE || (count > 0 && pixelMaterial != material))
+			{
+				ResolveBlock(row, columns, count, y, tileLights, _materialTable[material]);
+				count = 0;
+			}
+
+			material = pixelMaterial;
+			columns[count++] = x;
+		}
+
+		if (count > 0)
+		{
+			ResolveBlock(row, columns, count, y, tileLights, _materialTable[material]);
+		}
+	}
+}
+
+//
+// Lights up to a block of pixels. Missing lanes repeat the last pixel, and
+// are never written back.
+//
+void GBuffer::ResolveBlock(UINT32* row, const int* columns, const int& count, const int& y, const LightBuffer& lights, const GBufferMaterial& material) const
+{
+	const size_t rowStart = static_cast<size_t>(y) * _width;
+
+	alignas(16) float positions[3][FRAGMENT_BLOCK_SIZE];
+	alignas(16) float normals[3][FRAGMENT_BLOCK_SIZE];
+	alignas(16) UINT32 albedo[FRAGMENT_BLOCK_SIZE];
+
+	for (int lane = 0; lane < FRAGMENT_BLOCK_SIZE; ++lane)
+	{
+		const int x = columns[min(lane, count - 1)];
+		const size_t index = rowStart + x;
+
+		const Vector3 position = GetPosition(x, y, _depth[index]);
+		const Vector3 normal = DecodeNormal(_normals[index]);
+
+		positions[0][lane] = position.GetX();
+		positions[1][lane] = position.GetY();
+		positions[2][lane] = position.GetZ();
+
+		normals[0][lane] = normal.GetX();
+		normals[1][lane] = normal.GetY();
+		normals[2][lane] = normal.GetZ();
+
+		albedo[lane] = _albedo[index];
+	}
+
+	FragmentBlock fragments;
+	fragments.position = { _mm_load_ps(positions[0]), _mm_load_ps(positions[1]), _mm_load_ps(positions[2]) };
+	fragments.normal = { _mm_load_ps(normals[0]), _mm_load_ps(normals[1]), _mm_load_ps(normals[2]) };
+
+	const __m128i channel = _mm_set1_epi32(0xFF);
+	const __m128 range = _mm_set1_ps(255.f);
+	const __m128i texels = _mm_load_si128(reinterpret_cast<const __m128i*>(albedo));
+
+	// Albedo is stored as a pixel (0x00RRGGBB).
+	const ColourBlock surface{
+		_mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(texels, 16), channel)), range),
+		_mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(texels, 8), channel)), range),
+		_mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(texels, channel)), range) };
+
+	const ColourBlock colour = ColourBlock::Multiply(surface, lights.Evaluate(fragments, material.ambient, material.roughness, material.specular));
+
+	const __m128i red = _mm_cvttps_epi32(_mm_mul_ps(colour.red, range));
+	const __m128i green = _mm_cvttps_epi32(_mm_mul_ps(colour.green, range));
+	const __m128i blue = _mm_cvttps_epi32(_mm_mul_ps(colour.blue, range));
+
+	alignas(16) UINT32 pixels[FRAGMENT_BLOCK_SIZE];
+	_mm_store_si128(reinterpret_cast<__m128i*>(pixels), _mm_or_si128(_mm_or_si128(_mm_slli_epi32(red, 16), _mm_slli_epi32(green, 8)), blue));
+
+	for (int lane = 0; lane < count; ++lane)
+	{
+		row[columns[lane]] = pixels[lane];
+	}
+}
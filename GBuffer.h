@@ -0,0 +1,193 @@
+#pragma once
+#include <Windows.h>
+#include <vector>
+#include <cmath>
+#include "Vector.h"
+#include "Matrix.h"
+#include "Colour.h"
+#include "FrameBuffer.h"
+#include "LightGrid.h"
+
+//
+// Surface parameters which are the same over a whole mesh, and so are only
+// stored once per frame rather than on every pixel.
+//
+struct GBufferMaterial
+{
+	Colour ambient;
+	float roughness{ 0 };
+	float specular{ 0 };
+};
+
+//
+// Geometry buffer for deferred shading. Deferred meshes only record what
+// lighting needs for each pixel they cover: its depth, normal, albedo and
+// material. Once the whole scene has been drawn, the pixels which are still
+// visible are lit in a single pass, so every pixel is lit exactly once
+// however many triangles were drawn over it.
+//
+// Normals are octahedral encoded into two 16-bit values, and positions are
+// rebuilt from depth and the screen position, which keeps each pixel down
+// to 14 bytes.
+//
+class GBuffer
+{
+public:
+	//
+	// Forgets every pixel and material, ready for a new frame of the given target.
+	//
+	void Reset(const FrameBuffer& target);
+
+	//
+	// Registers the material of a mesh for the frame, and returns the index
+	// its pixels are written with.
+	//
+	const int AddMaterial(const GBufferMaterial& material);
+
+	//
+	// Records a pixel. Its depth has to be the one written into the depth buffer,
+	// pixels whose depth does not match when resolving were drawn over.
+	//
+	inline void Write(const int& x, const int& y, const float& depth, const Vector3& normal, const UINT32& albedo, const int& material);
+
+	//
+	// Lights every recorded pixel which is still visible, writing the result
+	// into the target. Positions are rebuilt with the camera's projection to
+	// screen space (before dehomogenising), which must be a perspective one.
+	//
+	void Resolve(const FrameBuffer& target, const LightGrid& lights, const Matrix& projection);
+
+	//
+	// Octahedral encoding of a unit vector into two 16-bit signed values.
+	//
+	static inline UINT32 EncodeNormal(const Vector3& normal);
+	static inline const Vector3 DecodeNormal(const UINT32& encoded);
+
+	static constexpr int NO_MATERIAL = -1;
+
+private:
+	//
+	// Lights the visible pixels of a single row.
+	//
+	void ResolveRow(const FrameBuffer& target, const LightGrid& lights, const int& y) const;
+
+	//
+	// Lights up to a block of pixels of the same row and material.
+	//
+	void ResolveBlock(UINT32* row, const int* columns, const int& count, const int& y, const LightBuffer& lights, const GBufferMaterial& material) const;
+
+	//
+	// Camera space position of a pixel, from its depth (1 / w).
+	//
+	inline const Vector3 GetPosition(const int& x, const int& y, const float& depth) const;
+
+	static inline const float SignNotZero(const float& value);
+
+private:
+	int _width{ 0 };
+	int _height{ 0 };
+
+	std::vector<float> _depth;
+	std::vector<UINT32> _normals;
+	std::vector<UINT32> _albedo;
+	std::vector<UINT16> _materials;
+
+	std::vector<GBufferMaterial> _materialTable;
+
+	//
+	// Projection to screen space, with the inverse of its upper left 2x2 block
+	// (x and y of the screen against x and y of the camera).
+	//
+	Matrix _projection;
+	float _inverse[2][2]{ { 1, 0 }, { 0, 1 } };
+};
+
+//
+// Records a pixel.
+//
+inline void GBuffer::Write(const int& x, const int& y, const float& depth, const Vector3& normal, const UINT32& albedo, const int& material)
+{
+	const size_t index = static_cast<size_t>(y) * _width + x;
+
+	_depth[index] = depth;
+	_normals[index] = EncodeNormal(normal);
+	_albedo[index] = albedo;
+	_materials[index] = static_cast<UINT16>(material);
+}
+
+//
+// Projects the vector onto the octahedron |x| + |y| + |z| = 1, folds the lower
+// half over the upper one and keeps x and y.
+//
+inline UINT32 GBuffer::EncodeNormal(const Vector3& normal)
+{
+	const float length = fabsf(normal.GetX()) + fabsf(normal.GetY()) + fabsf(normal.GetZ());
+
+	if (length == 0)
+	{
+		return 0;
+	}
+
+	float x = normal.GetX() / length;
+	float y = normal.GetY() / length;
+
+	if (normal.GetZ() < 0)
+	{
+		const float foldedX = (1 - fabsf(y)) * SignNotZero(x);
+		const float foldedY = (1 - fabsf(x)) * SignNotZero(y);
+
+		x = foldedX;
+		y = foldedY;
+	}
+
+	const UINT16 encodedX = static_cast<UINT16>(static_cast<INT16>(lroundf(x * 32767)));
+	const UINT16 encodedY = static_cast<UINT16>(static_cast<INT16>(lroundf(y * 32767)));
+
+	return static_cast<UINT32>(encodedX) | (static_cast<UINT32>(encodedY) << 16);
+}
+
+//
+// Unfolds the octahedron back into a unit vector.
+//
+inline const Vector3 GBuffer::DecodeNormal(const UINT32& encoded)
+{
+	float x = static_cast<INT16>(encoded & 0xFFFF) / 32767.f;
+	float y = static_cast<INT16>(encoded >> 16) / 32767.f;
+	const float z = 1 - fabsf(x) - fabsf(y);
+
+	if (z < 0)
+	{
+		const float unfoldedX = (1 - fabsf(y)) * SignNotZero(x);
+		const float unfoldedY = (1 - fabsf(x)) * SignNotZero(y);
+
+		x = unfoldedX;
+		y = unfoldedY;
+	}
+
+	const float length = sqrtf(x * x + y * y + z * z);
+
+	return length > 0 ? Vector3(x / length, y / length, z / length) : Vector3(0, 0, 1);
+}
+
+//
+// Camera space position of a pixel. The projection gives, for the centre of
+// the pixel at depth w, sx * w = m00 x + m01 y + m02 w + m03 (and likewise for
+// y), which only leaves a 2x2 system to solve.
+//
+inline const Vector3 GBuffer::GetPosition(const int& x, const int& y, const float& depth) const
+{
+	const float w = 1 / depth;
+
+	const float screenX = (static_cast<float>(x) + 0.5f - _projection.GetM(0, 2)) * w - _projection.GetM(0, 3);
+	const float screenY = (static_cast<float>(y) + 0.5f - _projection.GetM(1, 2)) * w - _projection.GetM(1, 3);
+
+	return Vector3(_inverse[0][0] * screenX + _inverse[0][1] * screenY, _inverse[1][0] * screenX + _inverse[1][1] * screenY, w);
+}
+
+//
+// 1 for positive values and zero, -1 otherwise.
+//
+inline const float GBuffer::SignNotZero(const float& value)
+{
+	return value >= 0 ? 1.f : -1.f;
+}
@@ -0,0 +1,170 @@
+#include "HalfSpaceRasteriser.h"
+#include <cmath>
+#include <algorithm>
+
+//
+// Rasterises a triangle with a single colour.
+//
+void HalfSpaceRasteriser::DrawFlat(const FrameBuffer& target, const PolygonData& clipSpace, const Colour& colour)
+{
+	EdgeData edges;
+
+	if (!SetupEdges(target, clipSpace, edges))
+	{
+		return;
+	}
+
+	const UINT32 pixel = FrameBuffer::Pack(colour.GetRed(), colour.GetGreen(), colour.GetBlue());
+
+	Rasterise(target, edges, [&pixel](UINT32* pixels, const int&, const int&, const float&, const float&, const int* offsets, const int& count)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			pixels[offsets[i]] = pixel;
+		}
+	});
+}
+
+//
+// Rasterises a triangle, interpolating the colour of its vertices.
+//
+void HalfSpaceRasteriser::DrawSmooth(const FrameBuffer& target, const PolygonData& clipSpace)
+{
+	EdgeData edges;
+
+	if (!SetupEdges(target, clipSpace, edges))
+	{
+		return;
+	}
+
+	const UnclampedColour c0(clipSpace.a.GetVertexData().GetColour());
+	const UnclampedColour c1(UnclampedColour(clipSpace.b.GetVertexData().GetColour()) - c0);
+	const UnclampedColour c2(UnclampedColour(clipSpace.c.GetVertexData().GetColour()) - c0);
+
+	const UnclampedColour colourStep(c1 * edges.weightStep1 + c2 * edges.weightStep2);
+
+	Rasterise(target, edges, [&](UINT32* pixels, const int&, const int&, const float& weight1, const float& weight2, const int* offsets, const int& count)
+	{
+		const UnclampedColour source(c0 + c1 * weight1 + c2 * weight2);
+
+		for (int i = 0; i < count; ++i)
+		{
+			const UnclampedColour colour(source + colourStep * static_cast<float>(offsets[i]));
+
+			pixels[offsets[i]] = FrameBuffer::Pack(colour.GetRed(), colour.GetGreen(), colour.GetBlue());
+		}
+	});
+}
+
+//
+// Rasterises a triangle, running the fragment function on every block row
+// with interpolated world positions, normals and (perspective correct) UVs.
+//
+void HalfSpaceRasteriser::DrawPhong(const FrameBuffer& target, const PolygonData& clipSpace, const PolygonData& worldSpace, const FragmentFunction& frag)
+{
+	EdgeData edges;
+
+	if (!SetupEdges(target, clipSpace, edges))
+	{
+		return;
+	}
+
+	const Vector3 p0(worldSpace.a);
+	const Vector3 p1(Vector3(worldSpace.b) - p0);
+	const Vector3 p2(Vector3(worldSpace.c) - p0);
+
+	const Vector3& n0(worldSpace.a.GetVertexData().GetNormal());
+	const Vector3 n1(worldSpace.b.GetVertexData().GetNormal() - n0);
+	const Vector3 n2(worldSpace.c.GetVertexData().GetNormal() - n0);
+
+	// UVs are interpolated divided by depth (along with 1 / depth itself in Z),
+	// and divided back on every pixel.
+	const float d0 = 1 / clipSpace.a.GetDepth();
+	const float d1 = 1 / clipSpace.b.GetDepth();
+	const float d2 = 1 / clipSpace.c.GetDepth();
+
+	const Vector3 uv0(Vector3(clipSpace.a.GetVertexData().GetUV()) * d0);
+	const Vector3 uv1(Vector3(clipSpace.b.GetVertexData().GetUV()) * d1);
+	const Vector3 uv2(Vector3(clipSpace.c.GetVertexData().GetUV()) * d2);
+
+	const Vector3 u0(uv0.GetX(), uv0.GetY(), d0);
+	const Vector3 u1(Vector3(uv1.GetX(), uv1.GetY(), d1) - u0);
+	const Vector3 u2(Vector3(uv2.GetX(), uv2.GetY(), d2) - u0);
+
+	FragmentSpan span;
+	FragmentGradients gradients;
+
+	gradients.worldStep = p1 * edges.weightStep1 + p2 * edges.weightStep2;
+	gradients.normalStep = n1 * edges.weightStep1 + n2 * edges.weightStep2;
+	gradients.uvStep = u1 * edges.weightStep1 + u2 * edges.weightStep2;
+
+	Rasterise(target, edges, [&](UINT32* pixels, const int& x, const int& y, const float& weight1, const float& weight2, const int* offsets, const int& count)
+	{
+		gradients.world = p0 + p1 * weight1 + p2 * weight2;
+		gradients.normal = n0 + n1 * weight1 + n2 * weight2;
+		gradients.uv = u0 + u1 * weight1 + u2 * weight2;
+
+		std::copy(offsets, offsets + count, span.offsets);
+		span.count = count;
+		span.x = x;
+		span.y = y;
+
+		span.Interpolate(gradients);
+
+		frag.Shade(span, pixels);
+	});
+}
+
+//
+// Builds the edge functions of a triangle and clamps its screen bounds to
+// the target's clip rectangle. Returns false if nothing would be drawn.
+//
+bool HalfSpaceRasteriser::SetupEdges(const FrameBuffer& target, const PolygonData& clipSpace, EdgeData& edges)
+{
+	const Vertex* const vertices[3]{ &clipSpace.a, &clipSpace.b, &clipSpace.c };
+
+	const float area = (clipSpace.b.GetX() - clipSpace.a.GetX()) * (clipSpace.c.GetY() - clipSpace.a.GetY()) -
+					   (clipSpace.b.GetY() - clipSpace.a.GetY()) * (clipSpace.c.GetX() - clipSpace.a.GetX());
+
+	if (area == 0 || std::isnan(area))
+	{
+		return false;
+	}
+
+	// Flip the edges of clockwise triangles so that inside is always positive.
+	const float orientation = area > 0 ? 1.f : -1.f;
+
+	for (int i = 0; i < 3; ++i)
+	{
+		const Vertex& from = *vertices[(i + 1) % 3];
+		const Vertex& to = *vertices[(i + 2) % 3];
+
+		edges.stepX[i] = -(to.GetY() - from.GetY()) * orientation;
+		edges.stepY[i] = (to.GetX() - from.GetX()) * orientation;
+		edges.origin[i] = edges.stepX[i] * (0.5f - from.GetX()) + edges.stepY[i] * (0.5f - from.GetY());
+
+		// Inside lies to the right of a left edge, and below a (horizontal) top edge.
+		edges.topLeft[i] = edges.stepX[i] > 0 || (edges.stepX[i] == 0 && edges.stepY[i] > 0);
+	}
+
+	edges.inverseArea = 1 / (area * orientation);
+	edges.weightStep1 = edges.stepX[1] * edges.inverseArea;
+	edges.weightStep2 = edges.stepX[2] * edges.inverseArea;
+
+	edges.depth0 = 1 / clipSpace.a.GetDepth();
+	edges.depthSlope1 = 1 / clipSpace.b.GetDepth() - edges.depth0;
+	edges.depthSlope2 = 1 / clipSpace.c.GetDepth() - edges.depth0;
+
+	// Pixels are sampled at their centres.
+	const float left = min(clipSpace.a.GetX(), min(clipSpace.b.GetX(), clipSpace.c.GetX()));
+	const float right = max(clipSpace.a.GetX(), max(clipSpace.b.GetX(), clipSpace.c.GetX()));
+	const float top = min(clipSpace.a.GetY(), min(clipSpace.b.GetY(), clipSpace.c.GetY()));
+	const float bottom = max(clipSpace.a.GetY(), max(clipSpace.b.GetY(), clipSpace.c.GetY()));
+
+	edges.minX = max(static_cast<int>(std::ceil(left - 0.5f)), target.clipLeft);
+	edges.minY = max(static_cast<int>(std::ceil(top - 0.5f)), target.clipTop);
+	edges.maxX = min(static_cast<int>(std::floor(right - 0.5f)) + 1, target.clipRight);
+	edges.maxY = min(static_cast<int>(std::floor(bottom - 0.5f)) + 1, target.clipBottom);
+
+	return edges.minX < edges.maxX && edges.minY < edges.maxY;
+}
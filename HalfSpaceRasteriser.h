@@ -0,0 +1,177 @@
+#pragma once
+#include <Windows.h>
+#include "Polygon3D.h"
+#include "UnclampedColour.h"
+#include "FrameBuffer.h"
+#include "TriangleRasteriser.h"
+
+//
+// Side (in pixels) of the square blocks the half-space rasteriser walks.
+//
+constexpr int HALFSPACE_BLOCK_SIZE = 8;
+
+//
+// Rasterises a triangle by evaluating its three edge functions over the
+// pixels of its screen bounds, instead of splitting it into top and bottom
+// flat halves. The bounds are walked in small square blocks which can be
+// rejected (or accepted) whole, and attributes are interpolated from the
+// barycentric weights the edge functions produce.
+//
+// Pixels follow the same top-left fill convention as the scanline rasteriser.
+//
+class HalfSpaceRasteriser
+{
+	//
+	// Raw polygon data structure.
+	//
+	struct PolygonData
+	{
+		const Vertex& a;
+		const Vertex& b;
+		const Vertex& c;
+	};
+
+	//
+	// Edge functions and screen bounds of a triangle. Edge i is the one
+	// opposite to vertex i, so its value (divided by the triangle's area)
+	// is the barycentric weight of that vertex.
+	//
+	struct EdgeData
+	{
+		float origin[3]{ 0, 0, 0 };		// Edge values at the centre of pixel (0, 0).
+		float stepX[3]{ 0, 0, 0 };		// Change in edge values for one pixel right.
+		float stepY[3]{ 0, 0, 0 };		// Change in edge values for one pixel down.
+		bool topLeft[3]{ false, false, false };
+
+		float inverseArea{ 0 };
+		float weightStep1{ 0 };			// Change in vertex b's weight for one pixel right.
+		float weightStep2{ 0 };			// Change in vertex c's weight for one pixel right.
+
+		float depth0{ 0 };
+		float depthSlope1{ 0 };
+		float depthSlope2{ 0 };
+
+		int minX{ 0 };
+		int minY{ 0 };
+		int maxX{ 0 };					// Exclusive
+		int maxY{ 0 };					// Exclusive
+	};
+
+public:
+	//
+	// Drawing handlers.
+	//
+	static void DrawFlat(const FrameBuffer& target, const PolygonData& clipSpace, const Colour& colour);
+	static void DrawSmooth(const FrameBuffer& target, const PolygonData& clipSpace);
+	static void DrawPhong(const FrameBuffer& target, const PolygonData& clipSpace, const PolygonData& worldSpace, const FragmentFunction& frag);
+
+private:
+	//
+	// Triangle setup.
+	//
+	static bool SetupEdges(const FrameBuffer& target, const PolygonData& clipSpace, EdgeData& edges);
+
+	//
+	// Walks the triangle's bounds and calls the shader for every block row with
+	// covered pixels passing the depth test. The shader receives the row (at
+	// the block's first pixel), the screen position of that pixel, the
+	// barycentric weights of vertices b and c on it, and the offsets of the
+	// pixels to fill.
+	//
+	template<typename TShader>
+	static void Rasterise(const FrameBuffer& target, const EdgeData& edges, const TShader& shader);
+
+	static bool IsCovered(const float& value, const bool& topLeft);
+};
+
+//
+// Whether a pixel lies inside an edge, pixels exactly on the edge only count
+// for top and left edges so that neighbouring triangles never share a pixel.
+//
+inline bool HalfSpaceRasteriser::IsCovered(const float& value, const bool& topLeft)
+{
+	return value > 0 || (value == 0 && topLeft);
+}
+
+//
+// Walks the triangle's bounds in blocks, skipping blocks which lie entirely
+// outside one of the edges, and skipping the per-pixel edge tests on blocks
+// which lie entirely inside all of them.
+//
+template<typename TShader>
+inline void HalfSpaceRasteriser::Rasterise(const FrameBuffer& target, const EdgeData& edges, const TShader& shader)
+{
+	for (int blockY = edges.minY; blockY < edges.maxY; blockY += HALFSPACE_BLOCK_SIZE)
+	{
+		const int blockHeight = min(HALFSPACE_BLOCK_SIZE, edges.maxY - blockY);
+
+		for (int blockX = edges.minX; blockX < edges.maxX; blockX += HALFSPACE_BLOCK_SIZE)
+		{
+			const int blockWidth = min(HALFSPACE_BLOCK_SIZE, edges.maxX - blockX);
+
+			float blockEdges[3];
+			bool outside = false;
+			bool inside = true;
+
+			for (int i = 0; i < 3; ++i)
+			{
+				blockEdges[i] = edges.origin[i] + edges.stepX[i] * blockX + edges.stepY[i] * blockY;
+
+				// Edge functions are linear, so their extremes over the block sit on its corners.
+				const float acrossX = edges.stepX[i] * (blockWidth - 1);
+				const float acrossY = edges.stepY[i] * (blockHeight - 1);
+
+				const float highest = blockEdges[i] + max(acrossX, 0.f) + max(acrossY, 0.f);
+				const float lowest = blockEdges[i] + min(acrossX, 0.f) + min(acrossY, 0.f);
+
+				outside = outside || highest < 0;
+				inside = inside && lowest > 0;
+			}
+
+			if (outside)
+			{
+				continue;
+			}
+
+			for (int y = blockY; y < blockY + blockHeight; ++y)
+			{
+				const int row = y - blockY;
+
+				const float rowEdge1 = blockEdges[1] + edges.stepY[1] * row;
+				const float rowEdge2 = blockEdges[2] + edges.stepY[2] * row;
+
+				float e0 = blockEdges[0] + edges.stepY[0] * row;
+				float e1 = rowEdge1;
+				float e2 = rowEdge2;
+
+				float* depths = target.GetDepthRow(y) + blockX;
+
+				int offsets[HALFSPACE_BLOCK_SIZE];
+				int count = 0;
+
+				for (int x = 0; x < blockWidth; ++x, e0 += edges.stepX[0], e1 += edges.stepX[1], e2 += edges.stepX[2])
+				{
+					if (!inside && !(IsCovered(e0, edges.topLeft[0]) && IsCovered(e1, edges.topLeft[1]) && IsCovered(e2, edges.topLeft[2])))
+					{
+						continue;
+					}
+
+					const float depth = edges.depth0 + edges.depthSlope1 * e1 * edges.inverseArea + edges.depthSlope2 * e2 * edges.inverseArea;
+
+					if (depth <= depths[x])
+					{
+						continue;
+					}
+
+					depths[x] = depth;
+					offsets[count++] = x;
+				}
+
+				if (count)
+				{
+					shader(target.GetRow(y) + blockX, blockX, y, rowEdge1 * edges.inverseArea, rowEdge2 * edges.inverseArea, offsets, count);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,240 @@
+#include "KeyframeStore.h"
+#include <cstring>
+#include <emmintrin.h>
+
+//
+// Vertices decoded at once by the interpolation kernel.
+//
+constexpr int KEYFRAME_LANES = 4;
+
+//
+// Byte offsets of our x, y and z within a packed vertex. We have Y as the up
+// axis where MD2 has Z, so y and z are swapped over.
+//
+constexpr int PACKED_X = 0;
+constexpr int PACKED_Y = 16;
+constexpr int PACKED_Z = 8;
+
+//
+// Empties the store. Frames are padded to a whole amount of lanes, so that the
+// kernel never has to load part of a frame.
+//
+void KeyframeStore::Reset(const int& vertexCount, const int& frameCount)
+{
+	_vertexCount = vertexCount;
+	_stride = (vertexCount + KEYFRAME_LANES - 1) / KEYFRAME_LANES * KEYFRAME_LANES;
+
+	_frames.assign(frameCount, Keyframe());
+	_vertices.assign(static_cast<size_t>(_stride) * frameCount, 0);
+
+	_bounds = BoundingBox();
+}
+
+//
+// Copies the packed vertices as they are, and swaps the Y and Z of the scale
+// and translation over instead. The bounds grow to contain the frame, from
+// the smallest and largest quantised value along each axis.
+//
+void KeyframeStore::SetFrame(const int& frame, const char* const name, const float (&scale)[3], const float (&translate)[3], const BYTE* vertices)
+{
+	Keyframe& keyframe = _frames[frame];
+
+	keyframe.scale[0] = scale[0];
+	keyframe.scale[1] = scale[2];
+	keyframe.scale[2] = scale[1];
+
+	keyframe.translate[0] = translate[0];
+	keyframe.translate[1] = translate[2];
+	keyframe.translate[2] = translate[1];
+
+	keyframe.name.assign(name, strnlen(name, 16));
+
+	UINT32* packed = _vertices.data() + static_cast<size_t>(_stride) * frame;
+	memcpy(packed, vertices, sizeof(UINT32) * _vertexCount);
+
+	if (_vertexCount == 0)
+	{
+		return;
+	}
+
+	const int shifts[3]{ PACKED_X, PACKED_Y, PACKED_Z };
+
+	UINT32 lowest[3]{ 0xFF, 0xFF, 0xFF };
+	UINT32 highest[3]{ 0, 0, 0 };
+
+	for (int i = 0; i < _vertexCount; ++i)
+	{
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			const UINT32 value = (packed[i] >> shifts[axis]) & 0xFF;
+
+			lowest[axis] = min(lowest[axis], value);
+			highest[axis] = max(highest[axis], value);
+		}
+	}
+
+	float minimum[3];
+	float maximum[3];
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		const float a = lowest[axis] * keyframe.scale[axis] + keyframe.translate[axis];
+		const float b = highest[axis] * keyframe.scale[axis] + keyframe.translate[axis];
+
+		minimum[axis] = min(a, b);
+		maximum[axis] = max(a, b);
+	}
+
+	const BoundingBox bounds{ { minimum[0], minimum[1], minimum[2] }, { maximum[0], maximum[1], maximum[2] } };
+
+	if (frame == 0)
+	{
+		_bounds = bounds;
+	}
+	else
+	{
+		_bounds.Encapsulate(bounds);
+	}
+}
+
+//
+// The amount of frames.
+//
+const int KeyframeStore::GetFrameCount() const
+{
+	return static_cast<int>(_frames.size());
+}
+
+//
+// The amount of vertices in every frame.
+//
+const int KeyframeStore::GetVertexCount() const
+{
+	return _vertexCount;
+}
+
+//
+// The name of a frame.
+//
+const std::string& KeyframeStore::GetFrameName(const int& frame) const
+{
+	return _frames[frame].name;
+}
+
+//
+// Bounds containing every frame.
+//
+const BoundingBox& KeyframeStore::GetBounds() const
+{
+	return _bounds;
+}
+
+//
+// Frames are numbered at the end of their names, the animation is the first
+// run of frames whose names match once their number is taken off.
+//
+const bool KeyframeStore::FindAnimation(const std::string& name, int& first, int& last) const
+{
+	const auto getAnimationName = [](const std::string& frameName)
+	{
+		const size_t end = frameName.find_last_not_of("0123456789");
+
+		return frameName.substr(0, end == std::string::npos ? 0 : end + 1);
+	};
+
+	first = -1;
+	last = -1;
+
+	for (int i = 0; i < GetFrameCount(); ++i)
+	{
+		if (getAnimationName(_frames[i].name) == name)
+		{
+			first = first < 0 ? i : first;
+			last = i;
+		}
+		else if (first >= 0)
+		{
+			break;
+		}
+	}
+
+	return first >= 0;
+}
+
+//
+// Every coordinate is p = q * scale + translate in each frame, so the blend
+// of two frames is qa * (sa * (1 - t)) + qb * (sb * t) + (ta * (1 - t) + tb * t).
+// The three factors are worked out once per axis, which leaves two multiplies
+// and two adds per coordinate. The kernel unpacks the bytes of four vertices
+// from each frame at a time, and writes the positions straight into the
+// vertex buffer.
+//
+void KeyframeStore::Interpolate(const int& from, const int& to, const float& blend, VertexBuffer& vertices) const
+{
+	const Keyframe& frameA = _frames[from];
+	const Keyframe& frameB = _frames[to];
+
+	float weightA[3];
+	float weightB[3];
+	float offset[3];
+
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		weightA[axis] = frameA.scale[axis] * (1 - blend);
+		weightB[axis] = frameB.scale[axis] * blend;
+		offset[axis] = frameA.translate[axis] * (1 - blend) + frameB.translate[axis] * blend;
+	}
+
+	const UINT32* packedA = _vertices.data() + static_cast<size_t>(_stride) * from;
+	const UINT32* packedB = _vertices.data() + static_cast<size_t>(_stride) * to;
+
+	float* x = vertices.GetX();
+	float* y = vertices.GetY();
+	float* z = vertices.GetZ();
+
+	const __m128i mask = _mm_set1_epi32(0xFF);
+
+	const __m128 weightAX = _mm_set1_ps(weightA[0]), weightAY = _mm_set1_ps(weightA[1]), weightAZ = _mm_set1_ps(weightA[2]);
+	const __m128 weightBX = _mm_set1_ps(weightB[0]), weightBY = _mm_set1_ps(weightB[1]), weightBZ = _mm_set1_ps(weightB[2]);
+	const __m128 offsetX = _mm_set1_ps(offset[0]), offsetY = _mm_set1_ps(offset[1]), offsetZ = _mm_set1_ps(offset[2]);
+
+	const auto unpack = [&](const __m128i& packed)
+	{
+		return _mm_cvtepi32_ps(_mm_and_si128(packed, mask));
+	};
+
+	for (int i = 0; i < _vertexCount; i += KEYFRAME_LANES)
+	{
+		const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(packedA + i));
+		const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(packedB + i));
+
+		const __m128 ax = unpack(_mm_srli_epi32(a, PACKED_X)), ay = unpack(_mm_srli_epi32(a, PACKED_Y)), az = unpack(_mm_srli_epi32(a, PACKED_Z));
+		const __m128 bx = unpack(_mm_srli_epi32(b, PACKED_X)), by = unpack(_mm_srli_epi32(b, PACKED_Y)), bz = unpack(_mm_srli_epi32(b, PACKED_Z));
+
+		const __m128 positionX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, weightAX), _mm_mul_ps(bx, weightBX)), offsetX);
+		const __m128 positionY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ay, weightAY), _mm_mul_ps(by, weightBY)), offsetY);
+		const __m128 positionZ = _mm_add_ps(_mm_add_ps(_mm_mul_ps(az, weightAZ), _mm_mul_ps(bz, weightBZ)), offsetZ);
+
+		if (i + KEYFRAME_LANES <= _vertexCount)
+		{
+			_mm_storeu_ps(x + i, positionX);
+			_mm_storeu_ps(y + i, positionY);
+			_mm_storeu_ps(z + i, positionZ);
+			continue;
+		}
+
+		// The frames are padded, but the vertex buffer is not.
+		alignas(16) float tail[3][KEYFRAME_LANES];
+
+		_mm_store_ps(tail[0], positionX);
+		_mm_store_ps(tail[1], positionY);
+		_mm_store_ps(tail[2], positionZ);
+
+		for (int lane = 0; i + lane < _vertexCount; ++lane)
+		{
+			x[i + lane] = tail[0][lane];
+			y[i + lane] = tail[1][lane];
+			z[i + lane] = tail[2][lane];
+		}
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <Windows.h>
+#include <vector>
+#include <string>
+#include "VertexBuffer.h"
+#include "Bounds.h"
+
+//
+// Every keyframe of an animated model, kept in the byte-packed form MD2 files
+// store them in. Each vertex takes four bytes: its position quantised against
+// the scale and translation of its frame, and a normal index which is not
+// used. A frame of a few hundred vertices fits in a couple of kilobytes, so
+// even long animations stay small, and poses are only ever decoded into the
+// vertex buffer of the mesh being drawn.
+//
+class KeyframeStore
+{
+public:
+	//
+	// Empties the store, ready for frameCount frames of vertexCount vertices.
+	//
+	void Reset(const int& vertexCount, const int& frameCount);
+
+	//
+	// Sets a frame from its MD2 data (where Z is up), given as the scale and
+	// translation of the frame and four bytes for every vertex.
+	//
+	void SetFrame(const int& frame, const char* const name, const float (&scale)[3], const float (&translate)[3], const BYTE* vertices);
+
+	//
+	// Accessors
+	//
+	const int GetFrameCount() const;
+	const int GetVertexCount() const;
+	const std::string& GetFrameName(const int& frame) const;
+
+	//
+	// Model-space bounds containing the vertices of every frame.
+	//
+	const BoundingBox& GetBounds() const;
+
+	//
+	// Finds the frames of a named animation, which are the consecutive frames
+	// whose names are the given one followed by a number ("run1" to "run6").
+	// Returns false if there are none.
+	//
+	const bool FindAnimation(const std::string& name, int& first, int& last) const;
+
+	//
+	// Writes the positions of the pose blend of the way from one frame to the
+	// other into the vertices, which must hold a vertex for each of the store's.
+	//
+	void Interpolate(const int& from, const int& to, const float& blend, VertexBuffer& vertices) const;
+
+private:
+	friend class MeshCache;
+
+	//
+	// Scale and translation of a frame, with Y as the up axis.
+	//
+	struct Keyframe
+	{
+		float scale[3];
+		float translate[3];
+		std::string name;
+	};
+
+	int _vertexCount{ 0 };
+	int _stride{ 0 };				// Vertices per frame, padded to a whole amount of SIMD lanes.
+
+	std::vector<Keyframe> _frames;
+	std::vector<UINT32> _vertices;	// Packed vertices of every frame, one frame after the other.
+
+	BoundingBox _bounds;
+};
@@ -1,5 +1,6 @@
 #include "Light.h"
 #include <math.h>
+#include <cfloat>
 
 //
 // Nothing to construct.
@@ -28,3 +29,105 @@ void Light::SetIntensity(const Colour& value)
 {
 	_intensity = value;
 }
+
+//
+// Lights reach everything by default.
+//
+const bool Light::GetBounds(BoundingSphere& bounds) const
+{
+	return false;
+}
+
+//
+// Lights are evaluated through their virtual functions by default.
+//
+void Light::Pack(LightBuffer& buffer)
+{
+	buffer.AddGeneric(*this);
+}
+
+//
+// Distance at which the light drops below the cutoff. Contributions fall off
+// as intensity / (attenuation * distance), so lights without any attenuation
+// never do.
+//
+const float Light::GetRange(const float& attenuation) const
+{
+	if (attenuation <= 0)
+	{
+		return FLT_MAX;
+	}
+
+	const float intensity = max(_intensity.GetRed(), max(_intensity.GetGreen(), _intensity.GetBlue()));
+
+	return intensity / (attenuation * LIGHT_CUTOFF);
+}
+
+//
+// Unpacks every lane of the block and calculates its contribution on its own.
+//
+ColourBlock Light::CalculateContributions(const FragmentBlock& fragments, const Colour& ambient, const float& roughness, const float& specular)
+{
+	alignas(16) float positions[3][FRAGMENT_BLOCK_SIZE];
+	alignas(16) float normals[3][FRAGMENT_BLOCK_SIZE];
+	alignas(16) float contributions[3][FRAGMENT_BLOCK_SIZE];
+
+	_mm_store_ps(positions[0], fragments.position.x);
+	_mm_store_ps(positions[1], fragments.position.y);
+	_mm_store_ps(positions[2], fragments.position.z);
+	_mm_store_ps(normals[0], fragments.normal.x);
+	_mm_store_ps(normals[1], fragments.normal.y);
+	_mm_store_ps(normals[2], fragments.normal.z);
+
+	for (int i = 0; i < FRAGMENT_BLOCK_SIZE; ++i)
+	{
+		const Vertex position(positions[0][i], positions[1][i], positions[2][i]);
+		const Vector3 normal(normals[0][i], normals[1][i], normals[2][i]);
+
+		const Colour contribution = CalculateContribution(position, normal, ambient, roughness, specular);
+
+		contributions[0][i] = contribution.GetRed();
+		contributions[1][i] = contribution.GetGreen();
+		contributions[2][i] = contribution.GetBlue();
+	}
+
+	return { _mm_load_ps(contributions[0]), _mm_load_ps(contributions[1]), _mm_load_ps(contributions[2]) };
+}
+
+//
+// Raises every lane to the given power. Whole exponents (the usual case for
+// roughness) are computed by repeated squaring, which also keeps the sign of
+// negative bases the way pow does, anything else falls back to pow per lane.
+//
+__m128 Light::Pow(const __m128& base, const float& exponent)
+{
+	const int wholeExponent = static_cast<int>(exponent);
+
+	if (static_cast<float>(wholeExponent) == exponent && wholeExponent >= 0)
+	{
+		__m128 result = _mm_set1_ps(1.f);
+		__m128 square = base;
+
+		for (int bits = wholeExponent; bits; bits >>= 1)
+		{
+			if (bits & 1)
+			{
+				result = _mm_mul_ps(result, square);
+			}
+
+			square = _mm_mul_ps(square, square);
+		}
+
+		return result;
+	}
+
+	alignas(16) float lanes[FRAGMENT_BLOCK_SIZE];
+	_mm_store_ps(lanes, base);
+
+	for (float& lane : lanes)
+	{
+		lane = static_cast<float>(pow(lane, exponent));
+	}
+
+	return _mm_load_ps(lanes);
+}
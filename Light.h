@@ -1,6 +1,15 @@
 #pragma once
 #include "Polygon3D.h"
 #include "Colour.h"
+#include "FragmentBlock.h"
+#include "Bounds.h"
+#include "LightBuffer.h"
+
+//
+// Contribution below which a light no longer visibly reaches a surface, one
+// step of an 8-bit colour channel.
+//
+constexpr float LIGHT_CUTOFF = 1.f / 256.f;
 
 //
 // Abstract implementation of a light structure.
@@ -19,7 +28,41 @@ public:
 	//
 	virtual Colour CalculateContribution(const Vertex& position, const Vector3& normal, const Colour& ambient, const float& roughness, const float& specular) = 0;
 
+	//
+	// Contribution calculator for a block of fragments (vectorised shading),
+	// for lights a light buffer has no arrays for. Runs the single fragment
+	// calculator on every lane.
+	//
+	virtual ColourBlock CalculateContributions(const FragmentBlock& fragments, const Colour& ambient, const float& roughness, const float& specular);
+
+	//
+	// The sphere within which the light can reach surfaces. Returns false if
+	// there is no such sphere, as the light reaches everything (by default).
+	//
+	virtual const bool GetBounds(BoundingSphere& bounds) const;
+
+	//
+	// Adds the light to a packed light buffer. Lights the buffer has no
+	// arrays for are kept as they are (by default).
+	//
+	virtual void Pack(LightBuffer& buffer);
+
+protected:
+	//
+	// Distance at which a light fading with the given (linear) attenuation
+	// drops below the cutoff.
+	//
+	const float GetRange(const float& attenuation) const;
+
+	//
+	// Raises every lane to the given power, like pow.
+	//
+	static __m128 Pow(const __m128& base, const float& exponent);
+
 private:
 	Colour _intensity;
+
+	// Packed lights share the same calculations.
+	friend class LightBuffer;
 };
 
@@ -0,0 +1,423 @@
+#include "LightBuffer.h"
+#include "Light.h"
+#include <cmath>
+
+//
+// Empties the buffer. The arrays keep their memory for the next frame's lights.
+//
+void LightBuffer::Clear(const Vector3& cameraPosition)
+{
+	_cameraPosition = cameraPosition;
+
+	_ambient.Clear();
+	_directional.Clear();
+	_point.Clear();
+	_spot.Clear();
+	_generic.clear();
+}
+
+//
+// Empties the ambient light arrays.
+//
+void LightBuffer::AmbientLights::Clear()
+{
+	count = 0;
+	red.clear();
+	green.clear();
+	blue.clear();
+}
+
+//
+// Empties the directional light arrays.
+//
+void LightBuffer::DirectionalLights::Clear()
+{
+	count = 0;
+	red.clear();
+	green.clear();
+	blue.clear();
+	directionX.clear();
+	directionY.clear();
+	directionZ.clear();
+}
+
+//
+// Empties the point light arrays.
+//
+void LightBuffer::PointLights::Clear()
+{
+	count = 0;
+	red.clear();
+	green.clear();
+	blue.clear();
+	positionX.clear();
+	positionY.clear();
+	positionZ.clear();
+	attenuation.clear();
+}
+
+//
+// Empties the spot light arrays.
+//
+void LightBuffer::SpotLights::Clear()
+{
+	count = 0;
+	red.clear();
+	green.clear();
+	blue.clear();
+	positionX.clear();
+	positionY.clear();
+	positionZ.clear();
+	directionX.clear();
+	directionY.clear();
+	directionZ.clear();
+	attenuation.clear();
+	innerCosine.clear();
+	outerCosine.clear();
+}
+
+//
+// Adds a light, which packs itself into the arrays of its type.
+//
+void LightBuffer::Add(Light& light)
+{
+	light.Pack(*this);
+}
+
+//
+// Adds an ambient light.
+//
+void LightBuffer::AddAmbient(const Colour& intensity)
+{
+	const size_t index = _ambient.count++;
+
+	Set(_ambient.red, index, intensity.GetRed());
+	Set(_ambient.green, index, intensity.GetGreen());
+	Set(_ambient.blue, index, intensity.GetBlue());
+}
+
+//
+// Adds a directional light, shining along the given direction.
+//
+void LightBuffer::AddDirectional(const Colour& intensity, const Vector3& direction)
+{
+	const size_t index = _directional.count++;
+	const Vector3 towardsLight = -direction;
+
+	Set(_directional.red, index, intensity.GetRed());
+	Set(_directional.green, index, intensity.GetGreen());
+	Set(_directional.blue, index, intensity.GetBlue());
+
+	Set(_directional.directionX, index, towardsLight.GetX());
+	Set(_directional.directionY, index, towardsLight.GetY());
+	Set(_directional.directionZ, index, towardsLight.GetZ());
+}
+
+//
+// Adds a point light.
+//
+void LightBuffer::AddPoint(const Colour& intensity, const Vector3& position, const float& attenuation)
+{
+	const size_t index = _point.count++;
+
+	Set(_point.red, index, intensity.GetRed());
+	Set(_point.green, index, intensity.GetGreen());
+	Set(_point.blue, index, intensity.GetBlue());
+
+	Set(_point.positionX, index, position.GetX());
+	Set(_point.positionY, index, position.GetY());
+	Set(_point.positionZ, index, position.GetZ());
+
+	Set(_point.attenuation, index, attenuation);
+}
+
+//
+// Adds a spot light, shining along the given direction. Its angles are
+// stored as cosines.
+//
+void LightBuffer::AddSpot(const Colour& intensity, const Vector3& position, const Vector3& direction, const float& attenuation, const float& innerAngle, const float& outerAngle)
+{
+	const size_t index = _spot.count++;
+	const Vector3 towardsLight = -direction;
+
+	Set(_spot.red, index, intensity.GetRed());
+	Set(_spot.green, index, intensity.GetGreen());
+	Set(_spot.blue, index, intensity.GetBlue());
+
+	Set(_spot.positionX, index, position.GetX());
+	Set(_spot.positionY, index, position.GetY());
+	Set(_spot.positionZ, index, position.GetZ());
+
+	Set(_spot.directionX, index, towardsLight.GetX());
+	Set(_spot.directionY, index, towardsLight.GetY());
+	Set(_spot.directionZ, index, towardsLight.GetZ());
+
+	Set(_spot.attenuation, index, attenuation);
+	Set(_spot.innerCosine, index, std::cos(innerAngle));
+	Set(_spot.outerCosine, index, std::cos(outerAngle));
+}
+
+//
+// Adds a light of a type the buffer does not know about.
+//
+void LightBuffer::AddGeneric(Light& light)
+{
+	_generic.push_back(&light);
+}
+
+//
+// Whether both buffers hold the same lights, seen from the same position.
+//
+const bool LightBuffer::operator==(const LightBuffer& rhs) const
+{
+	if (!_generic.empty() || !rhs._generic.empty() || !(_cameraPosition == rhs._cameraPosition))
+	{
+		return false;
+	}
+
+	return _ambient.count == rhs._ambient.count
+		&& _ambient.red == rhs._ambient.red && _ambient.green == rhs._ambient.green && _ambient.blue == rhs._ambient.blue
+
+		&& _directional.count == rhs._directional.count
+		&& _directional.red == rhs._directional.red && _directional.green == rhs._directional.green && _directional.blue == rhs._directional.blue
+		&& _directional.directionX == rhs._directional.directionX && _directional.directionY == rhs._directional.directionY && _directional.directionZ == rhs._directional.directionZ
+
+		&& _point.count == rhs._point.count
+		&& _point.red == rhs._point.red && _point.green == rhs._point.green && _point.blue == rhs._point.blue
+		&& _point.positionX == rhs._point.positionX && _point.positionY == rhs._point.positionY && _point.positionZ == rhs._point.positionZ
+		&& _point.attenuation == rhs._point.attenuation
+
+		&& _spot.count == rhs._spot.count
+		&& _spot.red == rhs._spot.red && _spot.green == rhs._spot.green && _spot.blue == rhs._spot.blue
+		&& _spot.positionX == rhs._spot.positionX && _spot.positionY == rhs._spot.positionY && _spot.positionZ == rhs._spot.positionZ
+		&& _spot.directionX == rhs._spot.directionX && _spot.directionY == rhs._spot.directionY && _spot.directionZ == rhs._spot.directionZ
+		&& _spot.attenuation == rhs._spot.attenuation
+		&& _spot.innerCosine == rhs._spot.innerCosine && _spot.outerCosine == rhs._spot.outerCosine;
+}
+
+//
+// Whether the buffers hold different lights.
+//
+const bool LightBuffer::operator!=(const LightBuffer& rhs) const
+{
+	return !(*this == rhs);
+}
+
+//
+// The total contribution of every light on a single position. Lanes hold
+// four lights of the same type, and are only added up at the very end. Every
+// contribution is clamped between 0 and 1 as it is added, like a single
+// light's colour, so none can take away from the others and clamping the
+// total once gives the same result as clamping after every light.
+//
+const Colour LightBuffer::Evaluate(const Vertex& position, const Vector3& normal, const Colour& ambient, const float& roughness, const float& specular) const
+{
+	const FragmentBlock fragment{ Vector3Block::Broadcast(Vector3(position)), Vector3Block::Broadcast(normal) };
+	const __m128 lanes = _mm_setr_ps(0, 1, 2, 3);
+
+	ColourBlock total{ _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() };
+
+	// Padding lanes are masked out rather than skipped.
+	const auto accumulate = [&](const ColourBlock& contribution, const size_t& index, const size_t& count)
+	{
+		const __m128 mask = _mm_cmplt_ps(_mm_add_ps(_mm_set1_ps(static_cast<float>(index)), lanes), _mm_set1_ps(static_cast<float>(count)));
+
+		const ColourBlock clamped = Clamp(contribution);
+
+		total.red = _mm_add_ps(total.red, _mm_and_ps(clamped.red, mask));
+		total.green = _mm_add_ps(total.green, _mm_and_ps(clamped.green, mask));
+		total.blue = _mm_add_ps(total.blue, _mm_and_ps(clamped.blue, mask));
+	};
+
+	const ColourBlock ambientBlock = ColourBlock::Broadcast(ambient);
+
+	for (size_t i = 0; i < _ambient.count; i += FRAGMENT_BLOCK_SIZE)
+	{
+		const ColourBlock intensity{ Load(_ambient.red, i), Load(_ambient.green, i), Load(_ambient.blue, i) };
+
+		accumulate(ShadeAmbient(intensity, ambientBlock), i, _ambient.count);
+	}
+
+	for (size_t i = 0; i < _directional.count; i += FRAGMENT_BLOCK_SIZE)
+	{
+		const ColourBlock intensity{ Load(_directional.red, i), Load(_directional.green, i), Load(_directional.blue, i) };
+		const Vector3Block direction{ Load(_directional.directionX, i), Load(_directional.directionY, i), Load(_directional.directionZ, i) };
+
+		accumulate(ShadeDirectional(intensity, direction, fragment, roughness, specular), i, _directional.count);
+	}
+
+	for (size_t i = 0; i < _point.count; i += FRAGMENT_BLOCK_SIZE)
+	{
+		const ColourBlock intensity{ Load(_point.red, i), Load(_point.green, i), Load(_point.blue, i) };
+		const Vector3Block lightPosition{ Load(_point.positionX, i), Load(_point.positionY, i), Load(_point.positionZ, i) };
+
+		accumulate(ShadePoint(intensity, lightPosition, Load(_point.attenuation, i), fragment, roughness, specular), i, _point.count);
+	}
+
+	for (size_t i = 0; i < _spot.count; i += FRAGMENT_BLOCK_SIZE)
+	{
+		const ColourBlock intensity{ Load(_spot.red, i), Load(_spot.green, i), Load(_spot.blue, i) };
+		const Vector3Block lightPosition{ Load(_spot.positionX, i), Load(_spot.positionY, i), Load(_spot.positionZ, i) };
+		const Vector3Block direction{ Load(_spot.directionX, i), Load(_spot.directionY, i), Load(_spot.directionZ, i) };
+
+		accumulate(ShadeSpot(intensity, lightPosition, direction, Load(_spot.attenuation, i), Load(_spot.innerCosine, i), Load(_spot.outerCosine, i), fragment), i, _spot.count);
+	}
+
+	alignas(16) float red[FRAGMENT_BLOCK_SIZE];
+	alignas(16) float green[FRAGMENT_BLOCK_SIZE];
+	alignas(16) float blue[FRAGMENT_BLOCK_SIZE];
+
+	_mm_store_ps(red, total.red);
+	_mm_store_ps(green, total.green);
+	_mm_store_ps(blue, total.blue);
+
+	const auto sum = [](const float (&lanes)[FRAGMENT_BLOCK_SIZE])
+	{
+		return min(max((lanes[0] + lanes[1]) + (lanes[2] + lanes[3]), 0.f), 1.f);
+	};
+
+	Colour result(sum(red), sum(green), sum(blue));
+
+	for (Light* const light : _generic)
+	{
+		result += light->CalculateContribution(position, normal, ambient, roughness, specular);
+	}
+
+	return result;
+}
+
+//
+// The total contribution of every light on a block of fragments. Lanes hold
+// the fragments, and every light is broadcast to all of them in turn, its
+// contribution clamped between 0 and 1 before it is added.
+//
+const ColourBlock LightBuffer::Evaluate(const FragmentBlock& fragments, const Colour& ambient, const float& roughness, const float& specular) const
+{
+	ColourBlock total = ColourBlock::Broadcast(Colour::Black);
+
+	const ColourBlock ambientBlock = ColourBlock::Broadcast(ambient);
+
+	for (size_t i = 0; i < _ambient.count; ++i)
+	{
+		const ColourBlock intensity{ Broadcast(_ambient.red, i), Broadcast(_ambient.green, i), Broadcast(_ambient.blue, i) };
+
+		total = ColourBlock::Add(total, Clamp(ShadeAmbient(intensity, ambientBlock)));
+	}
+
+	for (size_t i = 0; i < _directional.count; ++i)
+	{
+		const ColourBlock intensity{ Broadcast(_directional.red, i), Broadcast(_directional.green, i), Broadcast(_directional.blue, i) };
+		const Vector3Block direction{ Broadcast(_directional.directionX, i), Broadcast(_directional.directionY, i), Broadcast(_directional.directionZ, i) };
+
+		total = ColourBlock::Add(total, Clamp(ShadeDirectional(intensity, direction, fragments, roughness, specular)));
+	}
+
+	for (size_t i = 0; i < _point.count; ++i)
+	{
+		const ColourBlock intensity{ Broadcast(_point.red, i), Broadcast(_point.green, i), Broadcast(_point.blue, i) };
+		const Vector3Block lightPosition{ Broadcast(_point.positionX, i), Broadcast(_point.positionY, i), Broadcast(_point.positionZ, i) };
+
+		total = ColourBlock::Add(total, Clamp(ShadePoint(intensity, lightPosition, Broadcast(_point.attenuation, i), fragments, roughness, specular)));
+	}
+
+	for (size_t i = 0; i < _spot.count; ++i)
+	{
+		const ColourBlock intensity{ Broadcast(_spot.red, i), Broadcast(_spot.green, i), Broadcast(_spot.blue, i) };
+		const Vector3Block lightPosition{ Broadcast(_spot.positionX, i), Broadcast(_spot.positionY, i), Broadcast(_spot.positionZ, i) };
+		const Vector3Block direction{ Broadcast(_spot.directionX, i), Broadcast(_spot.directionY, i), Broadcast(_spot.directionZ, i) };
+
+		total = ColourBlock::Add(total, Clamp(ShadeSpot(intensity, lightPosition, direction, Broadcast(_spot.attenuation, i), Broadcast(_spot.innerCosine, i), Broadcast(_spot.outerCosine, i), fragments)));
+	}
+
+	for (Light* const light : _generic)
+	{
+		total = ColourBlock::Add(total, Clamp(light->CalculateContributions(fragments, ambient, roughness, specular)));
+	}
+
+	return total;
+}
+
+//
+// Ambient lights add the same constant everywhere.
+//
+const ColourBlock LightBuffer::ShadeAmbient(const ColourBlock& intensity, const ColourBlock& ambient) const
+{
+	return ColourBlock::Multiply(ambient, intensity);
+}
+
+//
+// Directional lights: diffuse term scaled by the highlights, see DirectionalLight.
+//
+const ColourBlock LightBuffer::ShadeDirectional(const ColourBlock& intensity, const Vector3Block& direction, const FragmentBlock& fragments, const float& roughness, const float& specular) const
+{
+	const __m128 lightValue = _mm_max_ps(Vector3Block::Dot(fragments.normal, direction), _mm_setzero_ps());
+
+	const Vector3Block eye(Vector3Block::NormaliseVector(Vector3Block::Subtract(Vector3Block::Broadcast(_cameraPosition), fragments.position)));
+
+	const Vector3Block h(Vector3Block::NormaliseVector(Vector3Block::Add(direction, eye)));
+	const __m128 phongHighlights = _mm_mul_ps(_mm_set1_ps(specular), Light::Pow(Vector3Block::Dot(fragments.normal, h), roughness));
+
+	return ColourBlock::Multiply(ColourBlock::Multiply(intensity, lightValue), phongHighlights);
+}
+
+//
+// Point lights: attenuated diffuse term plus highlights, see PointLight.
+//
+const ColourBlock LightBuffer::ShadePoint(const ColourBlock& intensity, const Vector3Block& position, const __m128& attenuation, const FragmentBlock& fragments, const float& roughness, const float& specular) const
+{
+	const Vector3Block lightRay = Vector3Block::Subtract(position, fragments.position);
+	const Vector3Block viewRay = Vector3Block::Subtract(Vector3Block::Broadcast(_cameraPosition), fragments.position);
+
+	const __m128 distance = Vector3Block::GetMagnitude(lightRay);
+	const __m128 falloff = _mm_div_ps(_mm_set1_ps(1.f), _mm_mul_ps(attenuation, distance));
+	const __m128 normalDotRay = _mm_max_ps(Vector3Block::Dot(fragments.normal, Vector3Block::NormaliseVector(lightRay)), _mm_setzero_ps());
+	const __m128 finalIntensity = _mm_mul_ps(normalDotRay, falloff);
+
+	const Vector3Block h(Vector3Block::NormaliseVector(Vector3Block::Add(lightRay, viewRay)));
+	const __m128 phongHighlights = _mm_mul_ps(_mm_set1_ps(specular), Light::Pow(Vector3Block::Dot(fragments.normal, h), roughness));
+
+	return ColourBlock::Multiply(intensity, _mm_add_ps(finalIntensity, phongHighlights));
+}
+
+//
+// Spot lights: attenuated diffuse term within the cone, see SpotLight.
+//
+const ColourBlock LightBuffer::ShadeSpot(const ColourBlock& intensity, const Vector3Block& position, const Vector3Block& direction, const __m128& attenuation, const __m128& innerCosine, const __m128& outerCosine, const FragmentBlock& fragments) const
+{
+	const Vector3Block lightRay = Vector3Block::Subtract(position, fragments.position);
+
+	const __m128 distance = Vector3Block::GetMagnitude(lightRay);
+	const __m128 falloff = _mm_div_ps(_mm_set1_ps(1.f), _mm_mul_ps(attenuation, distance));
+	const __m128 normalDotRay = _mm_max_ps(Vector3Block::Dot(fragments.normal, Vector3Block::NormaliseVector(lightRay)), _mm_setzero_ps());
+	const __m128 finalIntensity = _mm_mul_ps(normalDotRay, falloff);
+
+	const __m128 normalDotLight = Vector3Block::Dot(fragments.normal, direction);
+	const __m128 spotlightValue = Smoothstep(outerCosine, innerCosine, normalDotLight);
+
+	return ColourBlock::Multiply(ColourBlock::Multiply(intensity, finalIntensity), spotlightValue);
+}
+
+//
+// Writes a value at the index of an array, padding it to a whole amount of blocks.
+//
+void LightBuffer::Set(std::vector<float>& values, const size_t& index, const float& value)
+{
+	values.resize((index / FRAGMENT_BLOCK_SIZE + 1) * FRAGMENT_BLOCK_SIZE);
+	values[index] = value;
+}
+
+//
+// Smooth step over every lane, with lane-wise edges.
+//
+__m128 LightBuffer::Smoothstep(const __m128& a, const __m128& b, const __m128& x)
+{
+	const __m128 t = _mm_div_ps(_mm_sub_ps(x, a), _mm_sub_ps(b, a));
+	const __m128 value = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(3.f), _mm_mul_ps(_mm_set1_ps(2.f), t)), _mm_mul_ps(t, t));
+
+	const __m128 below = _mm_cmplt_ps(x, a);
+	const __m128 above = _mm_cmpgt_ps(x, b);
+
+	const __m128 clamped = _mm_or_ps(_mm_and_ps(above, _mm_set1_ps(1.f)), _mm_andnot_ps(above, value));
+
+	return _mm_andnot_ps(below, clamped);
+}
@@ -0,0 +1,170 @@
+#pragma once
+#include <vector>
+#include "Vector.h"
+#include "Vertex.h"
+#include "Colour.h"
+#include "FragmentBlock.h"
+
+// Forward declare lights
+class Light;
+
+//
+// Snapshot of a set of lights, taken once per frame. Lights are stored by
+// type as structures of arrays, along with the constants derived from them
+// and from the camera (normalised directions, spot light cosines), so that
+// they are evaluated straight from the arrays rather than one by one through
+// their virtual functions.
+//
+// Light types the buffer does not know about are kept aside and still
+// evaluated through their virtual functions.
+//
+class LightBuffer
+{
+public:
+	//
+	// Empties the buffer, the lights added next are seen from the given
+	// camera position.
+	//
+	void Clear(const Vector3& cameraPosition);
+
+	//
+	// Adds a light, which packs itself into the arrays of its type.
+	//
+	void Add(Light& light);
+
+	//
+	// Packing, called by the lights themselves. Directions are expected to be
+	// normalised already, as the lights keep them.
+	//
+	void AddAmbient(const Colour& intensity);
+	void AddDirectional(const Colour& intensity, const Vector3& direction);
+	void AddPoint(const Colour& intensity, const Vector3& position, const float& attenuation);
+	void AddSpot(const Colour& intensity, const Vector3& position, const Vector3& direction, const float& attenuation, const float& innerAngle, const float& outerAngle);
+	void AddGeneric(Light& light);
+
+	//
+	// The total contribution of every light on a single position, with the
+	// lights of each type evaluated four at a time.
+	//
+	const Colour Evaluate(const Vertex& position, const Vector3& normal, const Colour& ambient, const float& roughness, const float& specular) const;
+
+	//
+	// The total contribution of every light on a block of fragments.
+	//
+	const ColourBlock Evaluate(const FragmentBlock& fragments, const Colour& ambient, const float& roughness, const float& specular) const;
+
+	//
+	// Whether both buffers hold the same lights, seen from the same position.
+	// Buffers holding lights of unknown types are never equal, as there is no
+	// telling whether those changed.
+	//
+	const bool operator==(const LightBuffer& rhs) const;
+	const bool operator!=(const LightBuffer& rhs) const;
+
+private:
+	//
+	// Light arrays. Every array is padded with empty lights up to a whole
+	// amount of blocks, so that lights can always be read four at a time.
+	//
+	struct AmbientLights
+	{
+		size_t count{ 0 };
+		std::vector<float> red, green, blue;
+
+		void Clear();
+	};
+
+	struct DirectionalLights
+	{
+		size_t count{ 0 };
+		std::vector<float> red, green, blue;
+		std::vector<float> directionX, directionY, directionZ;		// Normalised, towards the light.
+
+		void Clear();
+	};
+
+	struct PointLights
+	{
+		size_t count{ 0 };
+		std::vector<float> red, green, blue;
+		std::vector<float> positionX, positionY, positionZ;
+		std::vector<float> attenuation;
+
+		void Clear();
+	};
+
+	struct SpotLights
+	{
+		size_t count{ 0 };
+		std::vector<float> red, green, blue;
+		std::vector<float> positionX, positionY, positionZ;
+		std::vector<float> directionX, directionY, directionZ;		// Normalised, towards the light.
+		std::vector<float> attenuation;
+		std::vector<float> innerCosine, outerCosine;
+
+		void Clear();
+	};
+
+	//
+	// Contributions of four lights on four positions. Either side may hold
+	// the same value on every lane.
+	//
+	const ColourBlock ShadeAmbient(const ColourBlock& intensity, const ColourBlock& ambient) const;
+	const ColourBlock ShadeDirectional(const ColourBlock& intensity, const Vector3Block& direction, const FragmentBlock& fragments, const float& roughness, const float& specular) const;
+	const ColourBlock ShadePoint(const ColourBlock& intensity, const Vector3Block& position, const __m128& attenuation, const FragmentBlock& fragments, const float& roughness, const float& specular) const;
+	const ColourBlock ShadeSpot(const ColourBlock& intensity, const Vector3Block& position, const Vector3Block& direction, const __m128& attenuation, const __m128& innerCosine, const __m128& outerCosine, const FragmentBlock& fragments) const;
+
+	//
+	// Writes a value at the index of an array, padding it to a whole amount of blocks.
+	//
+	static void Set(std::vector<float>& values, const size_t& index, const float& value);
+
+	//
+	// A contribution clamped between 0 and 1 on every channel.
+	//
+	static inline ColourBlock Clamp(const ColourBlock& contribution);
+
+	//
+	// Loads four values from an array, or broadcasts the one at the index.
+	//
+	static inline __m128 Load(const std::vector<float>& values, const size_t& index);
+	static inline __m128 Broadcast(const std::vector<float>& values, const size_t& index);
+
+	//
+	// Smooth step over every lane, with lane-wise edges.
+	//
+	static __m128 Smoothstep(const __m128& a, const __m128& b, const __m128& x);
+
+private:
+	Vector3 _cameraPosition;
+
+	AmbientLights _ambient;
+	DirectionalLights _directional;
+	PointLights _point;
+	SpotLights _spot;
+	std::vector<Light*> _generic;
+};
+
+//
+// Clamps every channel of a contribution between 0 and 1.
+//
+inline ColourBlock LightBuffer::Clamp(const ColourBlock& contribution)
+{
+	return { ColourBlock::Clamp(contribution.red), ColourBlock::Clamp(contribution.green), ColourBlock::Clamp(contribution.blue) };
+}
+
+//
+// Loads four values from an array.
+//
+inline __m128 LightBuffer::Load(const std::vector<float>& values, const size_t& index)
+{
+	return _mm_loadu_ps(values.data() + index);
+}
+
+//
+// The value at the index of an array, on every lane.
+//
+inline __m128 LightBuffer::Broadcast(const std::vector<float>& values, const size_t& index)
+{
+	return _mm_set1_ps(values[index]);
+}
@@ -0,0 +1,155 @@
+#include "LightGrid.h"
+#include <cmath>
+#include <cfloat>
+
+//
+// Bins the lights into the tiles of the target.
+//
+void LightGrid::Reset(const FrameBuffer& target, const Vector3& cameraPosition, const Matrix& projection, const float& nearPlane, const std::vector<std::shared_ptr<Light>>& lights)
+{
+	_width = target.width;
+	_height = target.height;
+	_tilesX = (_width + LIGHT_TILE_SIZE - 1) / LIGHT_TILE_SIZE;
+	_tilesY = (_height + LIGHT_TILE_SIZE - 1) / LIGHT_TILE_SIZE;
+
+	_tiles.resize(static_cast<size_t>(_tilesX) * _tilesY);
+
+	for (LightBuffer& tile : _tiles)
+	{
+		tile.Clear(cameraPosition);
+	}
+
+	_lights.Clear(cameraPosition);
+	_cameraPosition = cameraPosition;
+	_sources.clear();
+
+	for (const std::shared_ptr<Light>& light : lights)
+	{
+		_lights.Add(*light);
+
+		LightSource source;
+		source.light = light.get();
+		source.isBounded = light->GetBounds(source.bounds);
+
+		_sources.push_back(source);
+
+		int left = 0;
+		int top = 0;
+		int right = _tilesX - 1;
+		int bottom = _tilesY - 1;
+
+		if (source.isBounded && !GetTileBounds(source.bounds, projection, nearPlane, left, top, right, bottom))
+		{
+			continue;
+		}
+
+		for (int y = top; y <= bottom; ++y)
+		{
+			for (int x = left; x <= right; ++x)
+			{
+				_tiles[static_cast<size_t>(y) * _tilesX + x].Add(*light);
+			}
+		}
+	}
+}
+
+//
+// The lights which can reach a span of pixels starting at the given position.
+// Until the grid is reset, there are no tiles and no lights to return.
+//
+const LightBuffer& LightGrid::GetLights(const int& x, const int& y) const
+{
+	if (_tiles.empty())
+	{
+		return _lights;
+	}
+
+	const int tileX = min(max(x / LIGHT_TILE_SIZE, 0), _tilesX - 1);
+	const int tileY = min(max(y / LIGHT_TILE_SIZE, 0), _tilesY - 1);
+
+	return _tiles[static_cast<size_t>(tileY) * _tilesX + tileX];
+}
+
+//
+// Every light, wherever it reaches.
+//
+const LightBuffer& LightGrid::GetAllLights() const
+{
+	return _lights;
+}
+
+//
+// Packs the lights whose sphere overlaps the given one, along with the lights
+// which reach everything.
+//
+void LightGrid::GetLights(const BoundingSphere& bounds, LightBuffer& lights) const
+{
+	lights.Clear(_cameraPosition);
+
+	for (const LightSource& source : _sources)
+	{
+		const float reach = source.bounds.radius + bounds.radius;
+
+		if (!source.isBounded || (source.bounds.centre - bounds.centre).GetSqrMagnitude() <= reach * reach)
+		{
+			lights.Add(*source.light);
+		}
+	}
+}
+
+//
+// Finds the tiles covered by the screen bounds of the light's sphere. Light
+// positions are in the same (camera) space as the fragments they light, so
+// the corners of the box around the sphere are projected straight to the
+// screen. Spheres reaching past the near plane cannot be projected, and are
+// taken to cover the whole screen.
+//
+const bool LightGrid::GetTileBounds(const BoundingSphere& bounds, const Matrix& projection, const float& nearPlane, int& left, int& top, int& right, int& bottom) const
+{
+	const Vector3& centre = bounds.centre;
+
+	if (centre.GetZ() + bounds.radius < nearPlane)
+	{
+		return false;
+	}
+
+	if (centre.GetZ() - bounds.radius < nearPlane)
+	{
+		return true;
+	}
+
+	float minimumX = FLT_MAX;
+	float minimumY = FLT_MAX;
+	float maximumX = -FLT_MAX;
+	float maximumY = -FLT_MAX;
+
+	for (int corner = 0; corner < 8; ++corner)
+	{
+		const Vertex point = projection * Vertex(
+			centre.GetX() + (corner & 1 ? bounds.radius : -bounds.radius),
+			centre.GetY() + (corner & 2 ? bounds.radius : -bounds.radius),
+			centre.GetZ() + (corner & 4 ? bounds.radius : -bounds.radius),
+			1);
+
+		const float x = point.GetX() / point.GetW();
+		const float y = point.GetY() / point.GetW();
+
+		minimumX = min(minimumX, x);
+		minimumY = min(minimumY, y);
+		maximumX = max(maximumX, x);
+		maximumY = max(maximumY, y);
+	}
+
+	if (maximumX < 0 || maximumY < 0 || minimumX >= _width || minimumY >= _height)
+	{
+		return false;
+	}
+
+	// Tiles also list the lights of the tile to their right.
+	left = max(static_cast<int>(std::floor(minimumX)) / LIGHT_TILE_SIZE - 1, 0);
+	top = max(static_cast<int>(std::floor(minimumY)) / LIGHT_TILE_SIZE, 0);
+	right = min(static_cast<int>(std::floor(maximumX)) / LIGHT_TILE_SIZE, _tilesX - 1);
+	bottom = min(static_cast<int>(std::floor(maximumY)) / LIGHT_TILE_SIZE, _tilesY - 1);
+
+	return true;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include "Light.h"
+#include "LightBuffer.h"
+#include "Matrix.h"
+#include "FrameBuffer.h"
+#include "FragmentFunction.h"
+
+//
+// Size (in pixels) of the side of a light tile.
+//
+constexpr int LIGHT_TILE_SIZE = 64;
+
+//
+// A fragment span has to fit within a tile and the one to its right (see below).
+//
+static_assert(LIGHT_TILE_SIZE >= FRAGMENT_SPAN_LENGTH, "Fragment spans must not be longer than a light tile.");
+
+//
+// Splits the screen into square tiles and packs, for each one, the lights
+// which can reach any of its pixels. Lights without a range are packed in
+// every tile.
+//
+// Every tile also lists the lights of the tile to its right, so that a span
+// starting anywhere in a tile is covered by that tile's list alone.
+//
+class LightGrid
+{
+public:
+	//
+	// Bins the lights into the tiles of the target, given the camera's
+	// position, projection to screen space (before dehomogenising) and near
+	// plane.
+	//
+	void Reset(const FrameBuffer& target, const Vector3& cameraPosition, const Matrix& projection, const float& nearPlane, const std::vector<std::shared_ptr<Light>>& lights);
+
+	//
+	// The lights which can reach a span of pixels starting at the given
+	// position. Every light if the target had no tiles, and none before the
+	// grid is first reset.
+	//
+	const LightBuffer& GetLights(const int& x, const int& y) const;
+
+	//
+	// Every light, wherever it reaches, as of the last reset.
+	//
+	const LightBuffer& GetAllLights() const;
+
+	//
+	// Packs the lights which can reach any part of the given sphere (in the
+	// same camera space as the fragments they light) into the buffer.
+	//
+	void GetLights(const BoundingSphere& bounds, LightBuffer& lights) const;
+
+private:
+	//
+	// Finds the tiles the light's sphere of influence covers on screen.
+	// Returns false if it covers none.
+	//
+	const bool GetTileBounds(const BoundingSphere& bounds, const Matrix& projection, const float& nearPlane, int& left, int& top, int& right, int& bottom) const;
+
+private:
+	//
+	// A light of the scene, along with the sphere it reaches if it has one.
+	//
+	struct LightSource
+	{
+		Light* light{ nullptr };
+		BoundingSphere bounds;
+		bool isBounded{ false };
+	};
+
+private:
+	int _width{ 0 };
+	int _height{ 0 };
+	int _tilesX{ 0 };
+	int _tilesY{ 0 };
+
+	Vector3 _cameraPosition;
+	std::vector<LightSource> _sources;
+
+	LightBuffer _lights;
+	std::vector<LightBuffer> _tiles;
+};
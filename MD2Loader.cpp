@@ -1,8 +1,10 @@
 #include "MD2Loader.h"
 
 // File reading
-#include <iostream>
-#include <fstream>
+#include <cstddef>
+#include <climits>
+#include "MappedFile.h"
+#include "PcxDecoder.h"
 
 using namespace std;
 
@@ -15,6 +17,10 @@ const int MD2_IDENT = (('2' << 24) + ('P' << 16) + ('D' << 8) + 'I');
 // MS2 version
 const int MD2_VERSION = 8;
 
+// Limits of the format, which no valid file goes over.
+const int MD2_MAX_VERTICES = 2048;
+const int MD2_MAX_FRAMES = 512;
+
 struct Md2Header
 {
 	int indent;               // The magic number used to identify the file.
@@ -63,27 +69,6 @@ struct Md2Frame
 	Md2Vertex   verts[1];       // First vertex of this frame
 };
 
-struct PcxHeader
-{
-	BYTE  ID;
-	BYTE  Version;
-	BYTE  Encoding;
-	BYTE  BitsPerPixel;
-	short XMin;
-	short YMin;
-	short XMax;
-	short YMax;
-	short HRes;
-	short VRes;
-	BYTE  ClrMap[16 * 3];
-	BYTE  Reserved;
-	BYTE  NumPlanes;
-	short BytesPerLine;
-	short Pal;
-	BYTE  Filler[58];
-};
-
-
 MD2Loader::MD2Loader()
 {
 }
@@ -92,199 +77,132 @@ MD2Loader::~MD2Loader()
 {
 }
 
-bool LoadPCX(const char* textureFilename, Texture& texture, const Md2Header* md2Header)
+// Load model from file.
+//
+// The file is mapped into memory rather than read, and every array is decoded
+// straight from the mapped pages in a single pass into storage allocated up
+// front, which the mesh then takes over. The header is validated, along with
+// every array and index, before anything is handed over.
+//
+// Every frame is kept in the keyframe store as it is in the file, still
+// quantised, and the vertices start as the first frame decoded from it.
+
+bool MD2Loader::LoadModel(const char* md2Filename, const char* textureFilename, Mesh& model, SetPolygons setPolygons, SetVertices setVertices, SetTextureUVs setTextureUVs, SetKeyframes setKeyframes)
 {
-	std::ifstream   file;
-
-	BYTE* paletteIndices = texture.GetPaletteIndices();
-	COLORREF* palette = texture.GetPalette();
+	MappedFile file;
+	bool bHasTexture = false;
 
-	// Try to open file
-	file.open(textureFilename, std::ios::in | std::ios::binary);
-	if (file.fail())
+	// Try to open MD2 file
+	if (!file.Open(md2Filename))
 	{
 		return false;
 	}
-	// Read PCX header
-	PcxHeader header;
-	file.read(reinterpret_cast<char*>(&header), sizeof(PcxHeader));
 
-	// Verify that this is a valid PCX file
+	const Md2Header* header = file.Get<Md2Header>(0);
 
-	// We only handle those with 256 colour palette
-	if ((header.Version != 5) || (header.BitsPerPixel != 8) ||
-		(header.Encoding != 1) || (header.NumPlanes != 1) ||
-		(md2Header && (header.BytesPerLine != md2Header->skinWidth)))
+	// Verify that this is a MD2 file (check for the magic number and version number)
+	if (!header || header->indent != MD2_IDENT || header->version != MD2_VERSION)
 	{
-		// This is not valid supported PCX
-		file.close();
+		// This is not a MD2 model
 		return false;
 	}
 
-	//	Check dimensions
-
-	int xSize = header.XMax - header.XMin + 1;
-	int ySize = header.YMax - header.YMin + 1;
-	int size = xSize * ySize;
+	const int numVertices = header->numVertices;
+	const int numTriangles = header->numTriangles;
+	const int numTexCoords = header->numTexCoords;
+	const int numFrames = header->numFrames;
 
-	// Check that this matches our MD2 expected texture
-	// Note. valid size is <= because uses RLE (so potentially smaller)
-	if (md2Header && (size > (md2Header->skinHeight * md2Header->skinWidth)))
+	// Every frame must hold every vertex.
+	if (numVertices <= 0 || numVertices > MD2_MAX_VERTICES || numTriangles < 0 || numTexCoords < 0 || numFrames < 1 || numFrames > MD2_MAX_FRAMES ||
+		static_cast<UINT64>(header->frameSize) < offsetof(Md2Frame, verts) + sizeof(Md2Vertex) * static_cast<UINT64>(numVertices) ||
+		numFrames > INT_MAX / header->frameSize)
 	{
-		// Doesn't match expected MD2 skin size
-		file.close();
 		return false;
 	}
 
-	// Reading file data
+	const Md2Triangle* triangles = file.Get<Md2Triangle>(header->offsetTriangles, numTriangles);
+	const BYTE* frameData = file.Get<BYTE>(header->offsetFrames, header->frameSize * numFrames);
+	const Md2TextureCoord* textureCoords = file.Get<Md2TextureCoord>(header->offsetTexCoords, numTexCoords);
 
-	BYTE processByte, colourByte;
-	int count = 0;
-	while (count < size)
+	if (!triangles || !frameData || !textureCoords)
 	{
-		file.read(reinterpret_cast<char*>(&processByte), 1);
-
-		// Run length encoding - test if byte is an RLE byte
-		if ((processByte & 192) == 192)
-		{
-			// Extract number of times repeated byte
-			processByte &= 63;
-			file.read(reinterpret_cast<char*>(&colourByte), 1);
-			for (int index = 0; index < processByte; ++index)
-			{
-				// repeatedly write colour 
-				paletteIndices[count] = colourByte;
-				++count;
-			}
-		}
-		else
-		{
-			// Byte is the colour
-			paletteIndices[count] = processByte;
-			++count;
-		}
+		// Arrays reaching past the end of the file
+		return false;
 	}
 
-	bool returnValue = false;
+	// Polygon array initialization
+	std::vector<Polygon3D> polygons;
+	polygons.reserve(numTriangles);
 
-	// read palette data...
-	file.seekg(-769, std::ios::end);	// This offset from end of file
-	file.read(reinterpret_cast<char*>(&processByte), 1);
-	if (processByte == 12)
+	for (int i = 0; i < numTriangles; ++i)
 	{
-		BYTE rawPalette[768];
-		file.read(reinterpret_cast<char*>(&rawPalette), 768);
+		const short* vertexIndex = triangles[i].vertexIndex;
+		const short* uvIndex = triangles[i].uvIndex;
 
-		// Build palette
-		for (int palIndex = 0; palIndex < 256; ++palIndex)
+		for (int j = 0; j < 3; ++j)
 		{
-			palette[palIndex] = RGB(rawPalette[palIndex * 3],
-				rawPalette[(palIndex * 3) + 1],
-				rawPalette[(palIndex * 3) + 2]);
+			if (vertexIndex[j] < 0 || vertexIndex[j] >= numVertices ||
+				(numTexCoords > 0 && (uvIndex[j] < 0 || uvIndex[j] >= numTexCoords)))
+			{
+				return false;
+			}
 		}
-		returnValue = true;
-	}
-
-	file.close();
-	return returnValue;
-}
 
-// Load model from file.
-
-bool MD2Loader::LoadModel(const char* md2Filename, const char* textureFilename, Mesh& model, AddPolygon addPolygon, AddVertex addVertex, AddTextureUV addTextureUV)
-{
-	ifstream   file;
-	Md2Header header;
-	bool bHasTexture = false;
-
-	// Try to open MD2 file
-	file.open(md2Filename, ios::in | ios::binary);
-	if (file.fail())
-	{
-		return false;
+		polygons.emplace_back(vertexIndex[0], vertexIndex[1], vertexIndex[2], uvIndex[0], uvIndex[1], uvIndex[2]);
 	}
-	// Read file header
-	file.read(reinterpret_cast<char*>(&header), sizeof(Md2Header));
 
-	// Verify that this is a MD2 file (check for the magic number and version number)
-	if ((header.indent != MD2_IDENT) && (header.version != MD2_VERSION))
+	// Keyframe initialization
+	//
+	// The following are the expressions needed to access each of the co-ordinates.
+	// 
+	// X co-ordinate:   frame->verts[i].v[0] * frame->scale[0] + frame->translate[0]
+	// Y co-ordinate:   frame->verts[i].v[2] * frame->scale[2] + frame->translate[2]
+	// Z co-ordinate:   frame->verts[i].v[1] * frame->scale[1] + frame->translate[1]
+	//
+	// NOTE: We have to swap Y and Z over because Z is up in MD2 and we have Y as up-axis,
+	// which the keyframe store does when decoding.
+	KeyframeStore keyframes;
+	keyframes.Reset(numVertices, numFrames);
+
+	for (int i = 0; i < numFrames; ++i)
 	{
-		// This is not a MD2 model
-		file.close();
-		return false;
-	}
-
-	// Allocate the memory we need
-	Md2Triangle* triangles = new Md2Triangle[header.numTriangles];
-	// We are only interested in the first frame 
-	BYTE* frameBuffer = new BYTE[header.frameSize];
-	Md2Frame* frame = reinterpret_cast<Md2Frame*>(frameBuffer);
-	Md2TextureCoord* textureCoords = new Md2TextureCoord[header.numTexCoords];
+		const Md2Frame* frame = reinterpret_cast<const Md2Frame*>(frameData + header->frameSize * i);
 
-	// Read polygon data...
-	file.seekg(header.offsetTriangles, ios::beg);
-	file.read(reinterpret_cast<char*>(triangles), sizeof(Md2Triangle)* header.numTriangles);
-
-	// Read frame data...
-	file.seekg(header.offsetFrames, ios::beg);
-	file.read(reinterpret_cast<char*>(frame), header.frameSize);
+		keyframes.SetFrame(i, frame->name, frame->scale, frame->translate, reinterpret_cast<const BYTE*>(frame->verts));
+	}
 
-	// Read texture coordinate data
-	file.seekg(header.offsetTexCoords, std::ios::beg);
-	file.read(reinterpret_cast<char*>(textureCoords), sizeof(Md2TextureCoord)* header.numTexCoords);
+	// Vertex array initialization
+	VertexBuffer vertices;
+	vertices.Resize(numVertices);
 
-	// Close the file 
-	file.close();
+	keyframes.Interpolate(0, 0, 0, vertices);
 
-	// Attempt to load any texture
+	// Attempt to load any texture, which cannot be larger than the skin the UVs were made for
 	if (textureFilename)
 	{
-		model.GetTexture().SetTextureSize(header.skinWidth, header.skinHeight);
-		bHasTexture = LoadPCX(textureFilename, model.GetTexture(), &header);
-	}
+		const Texture& texture = model.GetTexture();
 
-	// Polygon array initialization
-	for (int i = 0; i < header.numTriangles; ++i)
-	{
-		// Call supplied member function to add a new polygon to the list
-		std::invoke(addPolygon, model,
-			triangles[i].vertexIndex[0], triangles[i].vertexIndex[1], triangles[i].vertexIndex[2],
-			triangles[i].uvIndex[0], triangles[i].uvIndex[1], triangles[i].uvIndex[2]);
+		bHasTexture = PcxDecoder::Load(textureFilename, model.GetTexture()) &&
+			texture.GetWidth() <= static_cast<size_t>(header->skinWidth) && texture.GetHeight() <= static_cast<size_t>(header->skinHeight);
 	}
 
-	// Vertex array initialization
-	for (int i = 0; i < header.numVertices; ++i)
-	{
-		// The following are the expressions needed to access each of the co-ordinates.
-		// 
-		// X co-ordinate:   frame->verts[i].v[0] * frame->scale[0] + frame->translate[0]
-		// Y co-ordinate:   frame->verts[i].v[2] * frame->scale[2] + frame->translate[2]
-		// Z co-ordinate:   frame->verts[i].v[1] * frame->scale[1] + frame->translate[1]
-		//
-		// NOTE: We have to swap Y and Z over because Z is up in MD2 and we have Y as up-axis
-		std::invoke(addVertex, model,
-			static_cast<float>((frame->verts[i].v[0] * frame->scale[0]) + frame->translate[0]),
-			static_cast<float>((frame->verts[i].v[2] * frame->scale[2]) + frame->translate[2]),
-			static_cast<float>((frame->verts[i].v[1] * frame->scale[1]) + frame->translate[1]));
-	}
 	// Texture coordinates initialisation
+	std::vector<Vector3> uvs;
+
 	if (bHasTexture)
 	{
-		for (int i = 0; i < header.numTexCoords; i++)
+		uvs.reserve(numTexCoords);
+
+		for (int i = 0; i < numTexCoords; i++)
 		{
-			std::invoke(addTextureUV, model, textureCoords[i].textureCoord[0], textureCoords[i].textureCoord[1]);
+			uvs.emplace_back(textureCoords[i].textureCoord[0], textureCoords[i].textureCoord[1], 0.f);
 		}
 	}
-	// Free dynamically allocated memory
-	delete[] triangles; // NOTE: this is 'array' delete. Must be sure to use this
-	triangles = 0;
-
-	delete[] frameBuffer;
-	frameBuffer = 0;
-	frame = 0;
 
-	delete[] textureCoords;
-	textureCoords = 0;
+	std::invoke(setPolygons, model, std::move(polygons));
+	std::invoke(setVertices, model, std::move(vertices));
+	std::invoke(setTextureUVs, model, std::move(uvs));
+	std::invoke(setKeyframes, model, std::move(keyframes));
 
 	return true;
-}
\ No newline at end of file
+}
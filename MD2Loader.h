@@ -1,12 +1,14 @@
 #pragma once
 #include "Mesh.h"
+#include "KeyframeStore.h"
 
-// Declare typedefs used by the MD2Loader to call the methods to add a vertex, 
-// add a polygon and add a texture UV to the lists
+// Declare typedefs used by the MD2Loader to call the methods which hand the
+// decoded vertices, polygons, texture UVs and keyframes over to the mesh, all at once
 
-typedef void (Mesh::* AddVertex)(float x, float y, float z);
-typedef void (Mesh::* AddPolygon)(int i0, int i1, int i2, int uvIndex0, int uvIndex1, int uvIndex2);
-typedef void (Mesh::* AddTextureUV)(float u, float v);
+typedef void (Mesh::* SetVertices)(VertexBuffer&& vertices);
+typedef void (Mesh::* SetPolygons)(std::vector<Polygon3D>&& polygons);
+typedef void (Mesh::* SetTextureUVs)(std::vector<Vector3>&& uvs);
+typedef void (Mesh::* SetKeyframes)(KeyframeStore&& keyframes);
 
 class MD2Loader
 {
@@ -14,5 +16,5 @@ public:
 	MD2Loader();
 	~MD2Loader();
 
-	static bool LoadModel(const char* md2Filename, const char* textureFilename, Mesh& model, AddPolygon addPolygon, AddVertex addVertex, AddTextureUV addTextureUV);
+	static bool LoadModel(const char* md2Filename, const char* textureFilename, Mesh& model, SetPolygons setPolygons, SetVertices setVertices, SetTextureUVs setTextureUVs, SetKeyframes setKeyframes);
 };
@@ -0,0 +1,96 @@
+#include "MappedFile.h"
+
+//
+// Unmaps the file.
+//
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+//
+// Maps the whole file for reading. It is going to be read from front to back,
+// which lets the operating system read ahead.
+//
+const bool MappedFile::Open(const char* const fileName)
+{
+	Close();
+
+	_file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if (_file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size;
+
+	// Empty files cannot be mapped.
+	if (!GetFileSizeEx(_file, &size) || size.QuadPart <= 0)
+	{
+		Close();
+		return false;
+	}
+
+	_mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (!_mapping)
+	{
+		Close();
+		return false;
+	}
+
+	_data = static_cast<const BYTE*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+
+	if (!_data)
+	{
+		Close();
+		return false;
+	}
+
+	_size = static_cast<size_t>(size.QuadPart);
+
+	return true;
+}
+
+//
+// Unmaps the file and closes it.
+//
+void MappedFile::Close()
+{
+	if (_data)
+	{
+		UnmapViewOfFile(_data);
+		_data = nullptr;
+	}
+
+	if (_mapping)
+	{
+		CloseHandle(_mapping);
+		_mapping = nullptr;
+	}
+
+	if (_file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(_file);
+		_file = INVALID_HANDLE_VALUE;
+	}
+
+	_size = 0;
+}
+
+//
+// The first byte of the file.
+//
+const BYTE* MappedFile::GetData() const
+{
+	return _data;
+}
+
+//
+// Size of the file in bytes.
+//
+const size_t MappedFile::GetSize() const
+{
+	return _size;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <Windows.h>
+
+//
+// Read-only view of a whole file, mapped into memory. Pages are read in by the
+// operating system the first time they are touched, so data can be decoded
+// straight from the file without reading it into buffers of our own first.
+//
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	//
+	// Maps the file, closing any file mapped before. Returns false if it
+	// cannot be opened, or is empty.
+	//
+	const bool Open(const char* const fileName);
+	void Close();
+
+	const BYTE* GetData() const;
+	const size_t GetSize() const;
+
+	//
+	// The count elements found at the offset, or null if any part of them
+	// lies outside of the file.
+	//
+	template<typename T>
+	const T* Get(const int& offset, const int& count = 1) const;
+
+private:
+	HANDLE _file{ INVALID_HANDLE_VALUE };
+	HANDLE _mapping{ nullptr };
+	const BYTE* _data{ nullptr };
+	size_t _size{ 0 };
+};
+
+//
+// The count elements found at the offset, if they lie within the file.
+//
+template<typename T>
+inline const T* MappedFile::Get(const int& offset, const int& count) const
+{
+	if (!_data || offset < 0 || count < 0)
+	{
+		return nullptr;
+	}
+
+	const size_t start = static_cast<size_t>(offset);
+	const size_t size = static_cast<size_t>(count) * sizeof(T);
+
+	if (start > _size || size > _size - start)
+	{
+		return nullptr;
+	}
+
+	return reinterpret_cast<const T*>(_data + start);
+}
@@ -1,6 +1,8 @@
 #include "Matrix.h"
+#include "VertexBuffer.h"
 #include <cmath>
 #include <exception>
+#include <emmintrin.h>
 
 Matrix::Matrix() : _m{ 0 }
 {
@@ -131,6 +133,158 @@ const Vector3 Matrix::operator*(const Vector3& v) const
 	return Vector3(x, y, z);
 }
 
+//
+// Transforms every position in the source buffer by the world matrix and by
+// the clip matrix (model, view, projection and projection-to-clip combined)
+// in a single pass, four positions at a time.
+//
+// Clip-space positions are divided by their W component, which is kept as
+// their depth. As the projection-to-clip matrix leaves W untouched, dividing
+// after it is the same as dehomogenising before it.
+//
+void Matrix::TransformBatch(const Matrix& world, const Matrix& clip, const VertexBuffer& source, VertexBuffer& worldSpace, VertexBuffer& clipSpace)
+{
+	const size_t count = source.GetCount();
+
+	worldSpace.Resize(count);
+	clipSpace.Resize(count);
+
+	const float* x = source.GetX();
+	const float* y = source.GetY();
+	const float* z = source.GetZ();
+	const float* w = source.GetW();
+
+	float* worldX = worldSpace.GetX();
+	float* worldY = worldSpace.GetY();
+	float* worldZ = worldSpace.GetZ();
+	float* worldW = worldSpace.GetW();
+
+	float* clipX = clipSpace.GetX();
+	float* clipY = clipSpace.GetY();
+	float* clipZ = clipSpace.GetZ();
+	float* clipW = clipSpace.GetW();
+	float* clipDepth = clipSpace.GetDepth();
+
+	__m128 worldM[ROWS][COLS];
+	__m128 clipM[ROWS][COLS];
+
+	for (int row = 0; row < ROWS; ++row)
+	{
+		for (int column = 0; column < COLS; ++column)
+		{
+			worldM[row][column] = _mm_set1_ps(world._m[row][column]);
+			clipM[row][column] = _mm_set1_ps(clip._m[row][column]);
+		}
+	}
+
+	const auto transformRow = [](const __m128 (&m)[COLS], const __m128& x, const __m128& y, const __m128& z, const __m128& w)
+	{
+		return _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[0], x), _mm_mul_ps(m[1], y)), _mm_add_ps(_mm_mul_ps(m[2], z), _mm_mul_ps(m[3], w)));
+	};
+
+	const __m128 one = _mm_set1_ps(1);
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 px = _mm_loadu_ps(x + i);
+		const __m128 py = _mm_loadu_ps(y + i);
+		const __m128 pz = _mm_loadu_ps(z + i);
+		const __m128 pw = _mm_loadu_ps(w + i);
+
+		_mm_storeu_ps(worldX + i, transformRow(worldM[0], px, py, pz, pw));
+		_mm_storeu_ps(worldY + i, transformRow(worldM[1], px, py, pz, pw));
+		_mm_storeu_ps(worldZ + i, transformRow(worldM[2], px, py, pz, pw));
+		_mm_storeu_ps(worldW + i, transformRow(worldM[3], px, py, pz, pw));
+
+		const __m128 depth = transformRow(clipM[3], px, py, pz, pw);
+
+		_mm_storeu_ps(clipX + i, _mm_div_ps(transformRow(clipM[0], px, py, pz, pw), depth));
+		_mm_storeu_ps(clipY + i, _mm_div_ps(transformRow(clipM[1], px, py, pz, pw), depth));
+		_mm_storeu_ps(clipZ + i, _mm_div_ps(transformRow(clipM[2], px, py, pz, pw), depth));
+		_mm_storeu_ps(clipW + i, one);
+		_mm_storeu_ps(clipDepth + i, depth);
+	}
+
+	// Remaining positions, one at a time...
+	for (; i < count; ++i)
+	{
+		const float px = x[i];
+		const float py = y[i];
+		const float pz = z[i];
+		const float pw = w[i];
+
+		worldX[i] = world._m[0][0] * px + world._m[0][1] * py + world._m[0][2] * pz + world._m[0][3] * pw;
+		worldY[i] = world._m[1][0] * px + world._m[1][1] * py + world._m[1][2] * pz + world._m[1][3] * pw;
+		worldZ[i] = world._m[2][0] * px + world._m[2][1] * py + world._m[2][2] * pz + world._m[2][3] * pw;
+		worldW[i] = world._m[3][0] * px + world._m[3][1] * py + world._m[3][2] * pz + world._m[3][3] * pw;
+
+		const float depth = clip._m[3][0] * px + clip._m[3][1] * py + clip._m[3][2] * pz + clip._m[3][3] * pw;
+
+		clipX[i] = (clip._m[0][0] * px + clip._m[0][1] * py + clip._m[0][2] * pz + clip._m[0][3] * pw) / depth;
+		clipY[i] = (clip._m[1][0] * px + clip._m[1][1] * py + clip._m[1][2] * pz + clip._m[1][3] * pw) / depth;
+		clipZ[i] = (clip._m[2][0] * px + clip._m[2][1] * py + clip._m[2][2] * pz + clip._m[2][3] * pw) / depth;
+		clipW[i] = 1; /* w/w = 1 */
+		clipDepth[i] = depth;
+	}
+}
+
+//
+// The cofactors of the upper 3x3 block are its inverse transpose scaled by its
+// determinant. Normals are normalised once transformed, so only the sign of
+// the determinant is kept, which keeps them facing out of mirrored shapes.
+//
+const Matrix Matrix::NormalMatrix() const
+{
+	const float c00 = _m[1][1] * _m[2][2] - _m[1][2] * _m[2][1];
+	const float c01 = _m[1][2] * _m[2][0] - _m[1][0] * _m[2][2];
+	const float c02 = _m[1][0] * _m[2][1] - _m[1][1] * _m[2][0];
+
+	const float c10 = _m[0][2] * _m[2][1] - _m[0][1] * _m[2][2];
+	const float c11 = _m[0][0] * _m[2][2] - _m[0][2] * _m[2][0];
+	const float c12 = _m[0][1] * _m[2][0] - _m[0][0] * _m[2][1];
+
+	const float c20 = _m[0][1] * _m[1][2] - _m[0][2] * _m[1][1];
+	const float c21 = _m[0][2] * _m[1][0] - _m[0][0] * _m[1][2];
+	const float c22 = _m[0][0] * _m[1][1] - _m[0][1] * _m[1][0];
+
+	const float determinant = _m[0][0] * c00 + _m[0][1] * c01 + _m[0][2] * c02;
+	const float sign = determinant < 0 ? -1.f : 1.f;
+
+	return Matrix
+	{
+		c00 * sign, c01 * sign, c02 * sign, 0,
+		c10 * sign, c11 * sign, c12 * sign, 0,
+		c20 * sign, c21 * sign, c22 * sign, 0,
+		0, 0, 0, 1
+	};
+}
+
+//
+// Transforms every normal by the normal matrix and normalises it.
+//
+void Matrix::TransformNormals(const Matrix& normalMatrix, const std::vector<Vector3>& source, std::vector<Vector3>& target)
+{
+	const float(&m)[ROWS][COLS] = normalMatrix._m;
+
+	target.resize(source.size());
+
+	for (size_t i = 0; i < source.size(); ++i)
+	{
+		const float x = source[i].GetX();
+		const float y = source[i].GetY();
+		const float z = source[i].GetZ();
+
+		const float nx = m[0][0] * x + m[0][1] * y + m[0][2] * z;
+		const float ny = m[1][0] * x + m[1][1] * y + m[1][2] * z;
+		const float nz = m[2][0] * x + m[2][1] * y + m[2][2] * z;
+
+		const float magnitude = std::sqrt(nx * nx + ny * ny + nz * nz);
+
+		target[i] = magnitude > 0 ? Vector3(nx / magnitude, ny / magnitude, nz / magnitude) : Vector3(0, 0, 0);
+	}
+}
+
 //
 // Returns the inverse of this matrix.
 //
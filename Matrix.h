@@ -8,6 +8,9 @@ const int ROWS = 4;
 const int COLS = 4;
 
 #include <initializer_list>
+#include <vector>
+
+class VertexBuffer;
 
 //
 // Transformation matrix
@@ -34,6 +37,25 @@ class Matrix
 
 		const Matrix Inverse() const;
 
+		//
+		// Batch transformation of every position in a vertex buffer, writing
+		// both its world-space and its dehomogenised clip-space counterparts.
+		//
+		static void TransformBatch(const Matrix& world, const Matrix& clip, const VertexBuffer& source, VertexBuffer& worldSpace, VertexBuffer& clipSpace);
+
+		//
+		// The matrix normals are transformed by alongside positions transformed
+		// by this one: the inverse transpose of its upper 3x3 block, up to a
+		// positive scale.
+		//
+		const Matrix NormalMatrix() const;
+
+		//
+		// Batch transformation of normals by a normal matrix, which are written
+		// into the target normalised. Zero normals stay zero.
+		//
+		static void TransformNormals(const Matrix& normalMatrix, const std::vector<Vector3>& source, std::vector<Vector3>& target);
+
 		//
 		// Information retrival
 		//
@@ -1,10 +1,17 @@
 ﻿#include "Mesh.h"
 #include "ModelLoadingException.h"
 #include "MD2Loader.h"
+#include "MeshCache.h"
 #include <algorithm>
 #include <windowsx.h>
 #include <memory>
 #include "Environment.h"
+#include "Bitmap.h"
+#include "ThreadPool.h"
+#include "Camera.h"
+#include <emmintrin.h>
+#include <cfloat>
+#include <cmath>
 
 //
 // Implements a basic unlit fragment function.
@@ -13,16 +20,21 @@ struct Unlit : public FragmentFunction
 {
 private:
 	const Texture& _texture;
+	const TextureFilter _filter;
 
 public:
-	inline Unlit(const Texture& texture) : _texture(texture)
+	inline Unlit(const Texture& texture, const TextureFilter& filter) : _texture(texture), _filter(filter)
 	{ }
 
-	inline const Colour operator()(const Vertex& v) const override
+	inline void Shade(const FragmentSpan& span, UINT32* row) const override
 	{
-		COLORREF sample = _texture.GetTextureValue((int)v.GetVertexData().GetUV().GetX(), (int)v.GetVertexData().GetUV().GetY());
+		UINT32 texels[FRAGMENT_SPAN_LENGTH];
+		_texture.SampleSpan<TextureAddress::ADDRESS_CLAMP>(span.u, span.v, span.count, span.texelFootprint, _filter, texels);
 
-		return Colour(sample);
+		for (int i = 0; i < span.count; ++i)
+		{
+			row[span.offsets[i]] = texels[i];
+		}
 	}
 };
 
@@ -35,19 +47,133 @@ private:
 	const float& _roughness;
 	const float& _specular;
 	const Texture& _texture;
-	const Colour& _albedo;
+	const Colour _albedo;
 	const Colour& _ambient;
+	const LightGrid& _lights;
+	const bool _vectorise;
+	const TextureFilter _filter;
 
 public:
-	inline Phong(const Colour& ambient, const float& roughness, const float& specular, const Texture& texture, const Colour& albedo) : _ambient{ ambient }, _roughness { roughness }, _specular{ specular }, _texture{ texture }, _albedo{ albedo }
+	inline Phong(const Colour& ambient, const float& roughness, const float& specular, const Texture& texture, const TextureFilter& filter, const Colour& albedo, const LightGrid& lights, const bool& vectorise) : _ambient{ ambient }, _roughness { roughness }, _specular{ specular }, _texture{ texture }, _filter{ filter }, _albedo{ albedo }, _lights{ lights }, _vectorise{ vectorise }
 	{ }
 
-	inline const Colour operator()(const Vertex& v) const override
+	inline void Shade(const FragmentSpan& span, UINT32* row) const override
+	{
+		// Padding included, blocks are read whole.
+		alignas(16) UINT32 texels[FRAGMENT_SPAN_LENGTH];
+		_texture.SampleSpan<TextureAddress::ADDRESS_CLAMP>(span.u, span.v, span.GetPaddedCount(), span.texelFootprint, _filter, texels);
+
+		if (_vectorise)
+		{
+			ShadeBlocks(span, texels, row);
+		}
+		else
+		{
+			ShadeFragments(span, texels, row);
+		}
+	}
+
+private:
+	//
+	// Shades every fragment on its own, this is the reference the vectorised
+	// path is tested against.
+	//
+	inline void ShadeFragments(const FragmentSpan& span, const UINT32* texels, UINT32* row) const
+	{
+		const LightBuffer& lights = _lights.GetLights(span.x, span.y);
+
+		for (int i = 0; i < span.count; ++i)
+		{
+			Vertex fragment(span.worldX[i], span.worldY[i], span.worldZ[i]);
+
+			fragment.GetVertexData().SetNormal(Vector3(span.normalX[i], span.normalY[i], span.normalZ[i]));
+
+			const Colour tex = Colour::FromPixel(texels[i]);
+			const Colour colour = tex * _albedo * lights.Evaluate(fragment, fragment.GetVertexData().GetNormal(), _ambient, _roughness, _specular);
+
+			row[span.offsets[i]] = FrameBuffer::Pack(colour.GetRed(), colour.GetGreen(), colour.GetBlue());
+		}
+	}
+
+	//
+	// Shades the span four fragments at a time with SSE.
+	//
+	inline void ShadeBlocks(const FragmentSpan& span, const UINT32* samples, UINT32* row) const
 	{
-		COLORREF sample = _texture.GetTextureValue((int)v.GetVertexData().GetUV().GetX(), (int)v.GetVertexData().GetUV().GetY());
-		Colour tex(sample);
+		const LightBuffer& lights = _lights.GetLights(span.x, span.y);
 
-		return tex * _albedo * Mesh::ComputeLighting(v, _ambient, _roughness, _specular);
+		const ColourBlock albedo = ColourBlock::Broadcast(_albedo);
+		const __m128i channel = _mm_set1_epi32(0xFF);
+		const __m128 range = _mm_set1_ps(255.f);
+
+		for (int i = 0; i < span.count; i += FRAGMENT_BLOCK_SIZE)
+		{
+			FragmentBlock fragments;
+			fragments.position = { _mm_loadu_ps(span.worldX + i), _mm_loadu_ps(span.worldY + i), _mm_loadu_ps(span.worldZ + i) };
+			fragments.normal = { _mm_loadu_ps(span.normalX + i), _mm_loadu_ps(span.normalY + i), _mm_loadu_ps(span.normalZ + i) };
+
+			const __m128i texels = _mm_load_si128(reinterpret_cast<const __m128i*>(samples + i));
+
+			const ColourBlock tex{
+				_mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(texels, 16), channel)), range),
+				_mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(texels, 8), channel)), range),
+				_mm_div_ps(_mm_cvtepi32_ps(_mm_and_si128(texels, channel)), range) };
+
+			const ColourBlock colour = ColourBlock::Multiply(ColourBlock::Multiply(tex, albedo), lights.Evaluate(fragments, _ambient, _roughness, _specular));
+
+			const __m128i red = _mm_cvttps_epi32(_mm_mul_ps(colour.red, range));
+			const __m128i green = _mm_cvttps_epi32(_mm_mul_ps(colour.green, range));
+			const __m128i blue = _mm_cvttps_epi32(_mm_mul_ps(colour.blue, range));
+
+			alignas(16) UINT32 pixels[FRAGMENT_BLOCK_SIZE];
+			_mm_store_si128(reinterpret_cast<__m128i*>(pixels), _mm_or_si128(_mm_or_si128(_mm_slli_epi32(red, 16), _mm_slli_epi32(green, 8)), blue));
+
+			// Padding lanes are shaded, but never written back.
+			const int lanes = min(FRAGMENT_BLOCK_SIZE, span.count - i);
+
+			for (int lane = 0; lane < lanes; ++lane)
+			{
+				row[span.offsets[i + lane]] = pixels[lane];
+			}
+		}
+	}
+};
+
+//
+// Records the pixels of a deferred mesh into the G-buffer rather than
+// lighting them, the colour buffer is only written once the scene is resolved.
+//
+struct Deferred : public FragmentFunction
+{
+private:
+	GBuffer& _gbuffer;
+	const FrameBuffer& _target;
+	const Texture& _texture;
+	const TextureFilter _filter;
+	const Colour _albedo;
+	const int _material;
+
+public:
+	inline Deferred(GBuffer& gbuffer, const FrameBuffer& target, const Texture& texture, const TextureFilter& filter, const Colour& albedo, const int& material) : _gbuffer{ gbuffer }, _target{ target }, _texture{ texture }, _filter{ filter }, _albedo{ albedo }, _material{ material }
+	{ }
+
+	inline void Shade(const FragmentSpan& span, UINT32* row) const override
+	{
+		// The rasteriser has already written the depth of every pixel in the span.
+		const float* depthRow = _target.GetDepthRow(span.y) + span.x;
+
+		UINT32 texels[FRAGMENT_SPAN_LENGTH];
+		_texture.SampleSpan<TextureAddress::ADDRESS_CLAMP>(span.u, span.v, span.count, span.texelFootprint, _filter, texels);
+
+		for (int i = 0; i < span.count; ++i)
+		{
+			const int offset = span.offsets[i];
+
+			const Colour tex = Colour::FromPixel(texels[i]);
+			const Colour albedo = tex * _albedo;
+
+			_gbuffer.Write(span.x + offset, span.y, depthRow[offset], Vector3(span.normalX[i], span.normalY[i], span.normalZ[i]), FrameBuffer::Pack(albedo.GetRed(), albedo.GetGreen(), albedo.GetBlue()), _material);
+		}
 	}
 };
 
@@ -64,19 +190,49 @@ Mesh::~Mesh()
 { }
 
 //
-// Loads the mesh data from a file.
+// Loads the mesh data from a file. Models are only parsed and prepared the
+// first time they are loaded, which writes everything the mesh keeps of them
+// into a cache file that every later load reads instead.
 //
-void Mesh::LoadFromFile(const char* const fileName, const char* texture)
+void Mesh::LoadFromFile(const char* const fileName, const char* texture, const bool& useCache)
 {
 	ClearVertices();
 	_polygons.clear();
+	_indices.clear();
+	_uv.clear();
+
+	SetKeyframes(KeyframeStore());
 
-	if (!MD2Loader::LoadModel(fileName, texture, *this, &Mesh::AddPolygon, &Mesh::AddVertex, &Mesh::AddUVcoord))
+	const std::string cacheName = MeshCache::GetCacheName(fileName);
+
+	if (useCache && MeshCache::Load(cacheName.c_str(), fileName, texture, *this))
+	{
+		return;
+	}
+
+	if (!MD2Loader::LoadModel(fileName, texture, *this, &Mesh::SetPolygons, &Mesh::SetVertices, &Mesh::SetUVcoords, &Mesh::SetKeyframes))
 	{
 		throw ModelLoadingException(fileName);
 	}
 
 	GenerateObjectNormals();
+
+	// Animated meshes are bounded by every frame they could be posed in, so
+	// that they never need their bounds recalculating.
+	if (_keyframes.GetFrameCount() > 1)
+	{
+		SetBounds(_keyframes.GetBounds());
+	}
+	else
+	{
+		CalculateBounds();
+	}
+
+	// Failing to write the cache only means parsing the model again next time.
+	if (useCache)
+	{
+		MeshCache::Save(cacheName.c_str(), fileName, texture, *this);
+	}
 }
 
 //
@@ -109,6 +265,10 @@ void Mesh::AddVertex(float x, float y, float z)
 void Mesh::AddPolygon(int i0, int i1, int i2, int u0, int u1, int u2)
 {
 	_polygons.push_back(Polygon3D(i0, i1, i2, u0, u1, u2));
+
+	_indices.push_back(i0);
+	_indices.push_back(i1);
+	_indices.push_back(i2);
 }
 
 //
@@ -120,79 +280,180 @@ void Mesh::AddUVcoord(float u, float v)
 }
 
 //
-// Recalculates the normals for all polygons.
+// Replaces every polygon.
 //
-void Mesh::GenerateObjectNormals()
+void Mesh::SetPolygons(std::vector<Polygon3D>&& polygons)
 {
-	const std::vector<Vertex>& objectVertices = GetVertices();
+	_polygons = std::move(polygons);
+	_indices.resize(_polygons.size() * INDICES_COUNT);
 
-	for (Polygon3D& polygon : _polygons)
+	for (size_t i = 0; i < _polygons.size(); ++i)
 	{
-		polygon.CalculateObjectNormal(objectVertices);
+		for (int j = 0; j < INDICES_COUNT; ++j)
+		{
+			_indices[i * INDICES_COUNT + j] = _polygons[i].GetVertex(j);
+		}
 	}
 }
 
 //
-// Recalculates the normals for all polygons in world space.
+// Replaces every set of UV coordinates.
+//
+void Mesh::SetUVcoords(std::vector<Vector3>&& uvs)
+{
+	_uv = std::move(uvs);
+}
+
+//
+// Replaces the keyframes, stopping any animation over the old ones, whose
+// frames may not exist anymore. The vertices are left in whatever pose they are.
 //
-void Mesh::GenerateWorldNormals()
+void Mesh::SetKeyframes(KeyframeStore&& keyframes)
 {
-	const std::vector<Vertex>& worldVertices = GetWorldSpaceVertices();
+	_keyframes = std::move(keyframes);
 
-	for (Polygon3D& polygon : _polygons)
+	_firstFrame = 0;
+	_lastFrame = 0;
+	_framesPerSecond = 0;
+	_animationTime = 0;
+	_isPoseValid = true;
+}
+
+//
+// Loops over a range of keyframes from the start, at the given rate. Ranges
+// outside of the keyframes are ignored.
+//
+void Mesh::PlayAnimation(const int& firstFrame, const int& lastFrame, const float& framesPerSecond)
+{
+	if (firstFrame < 0 || lastFrame < firstFrame || lastFrame >= _keyframes.GetFrameCount())
 	{
-		polygon.CalculateWorldNormal(worldVertices);
+		return;
 	}
+
+	_firstFrame = firstFrame;
+	_lastFrame = lastFrame;
+	_framesPerSecond = framesPerSecond;
+	_animationTime = 0;
+	_isPoseValid = false;
 }
 
 //
-// Recalculates the normals for all polygons in clip space.
+// Loops over the keyframes of a named animation.
 //
-void Mesh::GenerateClipNormals()
+const bool Mesh::PlayAnimation(const std::string& name, const float& framesPerSecond)
 {
-	const std::vector<Vertex>& clipVertices = GetClipSpaceVertices();
+	int firstFrame;
+	int lastFrame;
 
-	for (Polygon3D& polygon : _polygons)
+	if (!_keyframes.FindAnimation(name, firstFrame, lastFrame))
 	{
-		polygon.CalculateClipNormal(clipVertices);
+		return false;
 	}
+
+	PlayAnimation(firstFrame, lastFrame, framesPerSecond);
+
+	return true;
 }
 
 //
-// Recalculates the normals for the vertices of the mesh.
+// Holds the current pose. A pose the animation moved on to without the mesh
+// being drawn is interpolated first, as there is no rate to find it by after.
 //
-void Mesh::GenerateVertexNormals()
+void Mesh::StopAnimation()
 {
-	std::vector<Vertex>& worldVertices = GetWorldSpaceVertices();
-
-	for (Vertex& vertex : worldVertices)
+	if (!_isPoseValid)
 	{
-		vertex.GetVertexData().SetNormal({ 0, 0, 0 });
-		vertex.GetVertexData().SetContribution(0);
+		UpdatePose();
 	}
 
-	for (const Polygon3D& polygon : _polygons)
+	_framesPerSecond = 0;
+}
+
+//
+// Moves the animation on. The pose itself is left for when the mesh is drawn,
+// so meshes out of view cost nothing.
+//
+void Mesh::Animate(const float& deltaTime)
+{
+	if (_framesPerSecond <= 0)
 	{
-		Vertex& a = worldVertices[polygon.GetVertex(0)];
-		Vertex& b = worldVertices[polygon.GetVertex(1)];
-		Vertex& c = worldVertices[polygon.GetVertex(2)];
+		return;
+	}
 
-		const Vector3& normal = polygon.GetWorldNormal();
+	const float duration = (_lastFrame - _firstFrame + 1) / _framesPerSecond;
 
-		a.GetVertexData().AddNormal(normal);
-		a.GetVertexData().AddContribution(1);
+	_animationTime = fmodf(_animationTime + deltaTime, duration);
+	_isPoseValid = false;
+}
 
-		b.GetVertexData().AddNormal(normal);
-		b.GetVertexData().AddContribution(1);
+//
+// The keyframes loaded with the mesh.
+//
+const KeyframeStore& Mesh::GetKeyframes() const
+{
+	return _keyframes;
+}
+
+//
+// Blends the two keyframes either side of the current time straight into the
+// model-space vertices, which then need their normals calculating again. The
+// last frame blends back into the first, so animations loop smoothly.
+//
+void Mesh::UpdatePose()
+{
+	const int frameCount = _lastFrame - _firstFrame + 1;
+	const float position = _animationTime * _framesPerSecond;
+	const int frame = min(static_cast<int>(position), frameCount - 1);
+
+	_keyframes.Interpolate(_firstFrame + frame, _firstFrame + (frame + 1) % frameCount, position - frame, EditVertices());
+
+	GenerateObjectNormals();
 
-		c.GetVertexData().AddNormal(normal);
-		c.GetVertexData().AddContribution(1);
+	_isPoseValid = true;
+}
+
+//
+// Calculates the model-space normal of every polygon, and the smooth normal
+// of every vertex from the polygons sharing it. These only need calculating
+// when the mesh is loaded or posed; drawing transforms them.
+//
+void Mesh::GenerateObjectNormals()
+{
+	const VertexBuffer& objectVertices = GetVertices();
+
+	_vertexNormals.assign(objectVertices.GetCount(), Vector3(0, 0, 0));
+
+	_faceNormals.resize(_polygons.size());
+
+	for (size_t i = 0; i < _polygons.size(); ++i)
+	{
+		const Polygon3D& polygon = _polygons[i];
+
+		_faceNormals[i] = polygon.CalculateNormal(objectVertices);
+
+		for (int j = 0; j < INDICES_COUNT; ++j)
+		{
+			_vertexNormals[polygon.GetVertex(j)] += _faceNormals[i];
+		}
 	}
 
-	for (Vertex& vertex : worldVertices)
+	for (Vector3& normal : _vertexNormals)
 	{
-		vertex.GetVertexData().DivideNormalByContribution();
+		if (normal.GetSqrMagnitude() > 0)
+		{
+			normal.Normalise();
+		}
 	}
+
+	SetNormals(_vertexNormals);
+}
+
+//
+// The world-space normal of one of this mesh's polygons.
+//
+const Vector3& Mesh::GetWorldNormal(const Polygon3D& polygon) const
+{
+	return _worldFaceNormals[&polygon - _polygons.data()];
 }
 
 //
@@ -200,26 +461,53 @@ void Mesh::GenerateVertexNormals()
 //
 void Mesh::Draw(HDC hdc)
 {
-	if (_drawMode == DrawMode::DRAW_NONE)
+	// Meshes the camera cannot see need no per-vertex work at all.
+	if (_drawMode == DrawMode::DRAW_NONE || !IsInView())
 	{
 		return;
 	}
 
-	CalculateTransformations();
+	// Animated meshes are only posed when they can be seen.
+	if (!_isPoseValid)
+	{
+		UpdatePose();
+	}
+
+	// Meshes built polygon by polygon rather than loaded have no normals yet.
+	if (_faceNormals.size() != _polygons.size())
+	{
+		GenerateObjectNormals();
+	}
+
+	// Vertex normals are transformed along with the positions, polygon normals
+	// only need to follow when those changed.
+	if (CalculateTransformations())
+	{
+		Matrix::TransformNormals(GetNormalMatrix(), _faceNormals, _worldFaceNormals);
+
+		_areVertexColoursValid = false;
+	}
 
 	// Calculate transformed vertices
 	const auto& clipSpace = GetClipSpaceVertices();
 	const auto& worldSpace = GetWorldSpaceVertices();
 
-	GenerateWorldNormals();
-	GenerateClipNormals();
-
 	CalculateBackfaceCulling(clipSpace);
-	CalculateDepthSorting(clipSpace);
 
-	if (_drawMode == DrawMode::DRAW_FRAGMENT)
+	// GDI drawn polygons have no depth buffer to rely on, so they must be drawn
+	// back to front (painter's algorithm).
+	if (_drawMode != DrawMode::DRAW_FRAGMENT)
+	{
+		CalculateDepthSorting(clipSpace);
+	}
+	else if (_doDepthSorting)
+	{
+		CalculateDepthSorting(clipSpace, true);
+	}
+
+	if (_drawMode == DrawMode::DRAW_FRAGMENT && _shadeMode == ShadeMode::SHADE_FLAT)
 	{
-		GenerateVertexNormals();
+		ComputePolygonLighting();
 	}
 
 	if (_drawMode == DrawMode::DRAW_FRAGMENT && _shadeMode == ShadeMode::SHADE_GOURAUD)
@@ -227,6 +515,33 @@ void Mesh::Draw(HDC hdc)
 		ComputeVertexLighting();
 	}
 
+	// Positions are rebuilt from depth when resolving the G-buffer, which needs
+	// a perspective camera. Without one, deferred meshes are shaded as phong.
+	_deferredMaterial = GBuffer::NO_MATERIAL;
+
+	if (_drawMode == DrawMode::DRAW_FRAGMENT && _shadeMode == ShadeMode::SHADE_DEFERRED && Camera::GetMainCamera() && Camera::GetMainCamera()->IsPerspective())
+	{
+		_deferredMaterial = Environment::GetActive().GetGBuffer().AddMaterial({ _ambient, _roughness, _specular });
+	}
+
+	// Fragments are written straight into the active bitmap's colour buffer.
+	const FrameBuffer& target = Bitmap::GetActive()->GetFrameBuffer();
+
+	if (const Camera* const mainCamera = Camera::GetMainCamera())
+	{
+		_clipper.Reset(mainCamera->GetConstants().projectionClip, mainCamera->GetNearPlane(), target);
+	}
+	else
+	{
+		_clipper.Reset(Matrix::IdentityMatrix(), 0, target);
+	}
+
+	if (_drawMode == DrawMode::DRAW_FRAGMENT && _doBinning)
+	{
+		DrawFragBinned(clipSpace, worldSpace, target);
+		return;
+	}
+
 	for (const Polygon3D* polygon : _visiblePolygons)
 	{
 		switch (_drawMode)
@@ -238,7 +553,7 @@ void Mesh::Draw(HDC hdc)
 			DrawSolidPolygon(*polygon, clipSpace, worldSpace, hdc);
 			break;
 		case DrawMode::DRAW_FRAGMENT:
-			DrawFragPolygon(*polygon, clipSpace, worldSpace, hdc);
+			DrawFragPolygon(*polygon, clipSpace, worldSpace, target);
 			break;
 		}
 	}
@@ -260,12 +575,62 @@ void Mesh::Shade(const ShadeMode& mode)
 	_shadeMode = mode;
 }
 
+//
+// Which rasteriser should fill the triangles of this mesh when it is drawn
+// fragment by fragment.
+//
+void Mesh::Engine(const RasterEngine& engine)
+{
+	_rasterEngine = engine;
+}
+
+//
+// How the texture of this mesh is filtered when it is drawn fragment by
+// fragment.
+//
+void Mesh::Filter(const TextureFilter& filter)
+{
+	_textureFilter = filter;
+}
+
 //
 // Sets whether or not this mesh should perform backface culling.
 //
 void Mesh::Cull(const bool& mode)
 {
 	_doBackfaceCulling = mode;
+
+	// Vertices of polygons which become visible were never lit.
+	_areVertexColoursValid = false;
+}
+
+//
+// Sets whether or not fragment drawn polygons should be sorted into screen
+// tiles and rasterised in parallel. The output is identical either way.
+//
+void Mesh::Bin(const bool& mode)
+{
+	_doBinning = mode;
+}
+
+//
+// Sets whether or not phong shaded fragments should be shaded in blocks with
+// SSE. Otherwise every fragment is shaded on its own, which is the reference
+// the vectorised path is tested against.
+//
+void Mesh::Vectorise(const bool& mode)
+{
+	_doVectorising = mode;
+}
+
+//
+// Sets whether or not fragment drawn polygons should be sorted front to back
+// before rasterising. The depth buffer keeps the output correct either way, this
+// only lets hidden fragments be rejected before they are shaded.
+//
+void Mesh::DepthSort(const bool& mode)
+{
+	_doDepthSorting = mode;
 }
 
 //
@@ -347,54 +712,128 @@ void Mesh::ResetActiveColour(const HDC& hdc)
 // Calculates which polygons should be backface culled and sorts all others in
 // a list.
 //
-void Mesh::CalculateBackfaceCulling(const std::vector<Vertex>& vertices)
+// A polygon faces the camera when the determinant of its homogeneous clip
+// space positions (x * w, y * w, w), with w kept as the depth, is positive.
+// This is the signed area of its screen triangle scaled by the depth of each
+// vertex, but unlike the screen area it keeps its sign for polygons crossing
+// the near plane. Vertices at a depth of 0 have no screen position at all,
+// which makes the determinant NaN, and those are kept for the clipper to
+// decide. Determinants are worked out four polygons at a time, and visible
+// polygons are written out without branching.
+//
+void Mesh::CalculateBackfaceCulling(const VertexBuffer& vertices)
 {
-	Matrix transform = _doBackfaceCulling ? GetMVP(MVP) : Matrix::IdentityMatrix();
-	_visiblePolygons.clear();
+	const size_t count = _polygons.size();
+
+	_visiblePolygons.resize(count);
 
-	for (Polygon3D& polygon : _polygons)
+	if (!_doBackfaceCulling)
 	{
-		if (_doBackfaceCulling)
+		for (size_t i = 0; i < count; ++i)
 		{
-			Vector3 normal = polygon.GetClipNormal();
-			Vector3 view = polygon.CalculateCenter(vertices).AsVector();
+			_visiblePolygons[i] = &_polygons[i];
+		}
 
-			normal.Normalise();
-			view.Normalise();
+		return;
+	}
 
-			if (Vector3::Dot(normal, view) > 0)
-			{
-				_visiblePolygons.push_back(&polygon);
-			}
-		}
-		else
+	const float* x = vertices.GetX();
+	const float* y = vertices.GetY();
+	const float* w = vertices.GetDepth();
+	const int* indices = _indices.data();
+
+	const auto getDeterminant = [&](const size_t& i)
+	{
+		const int a = indices[i * INDICES_COUNT];
+		const int b = indices[i * INDICES_COUNT + 1];
+		const int c = indices[i * INDICES_COUNT + 2];
+
+		const float ax = x[a] * w[a], ay = y[a] * w[a];
+		const float bx = x[b] * w[b], by = y[b] * w[b];
+		const float cx = x[c] * w[c], cy = y[c] * w[c];
+
+		return ax * (by * w[c] - w[b] * cy) - ay * (bx * w[c] - w[b] * cx) + w[a] * (bx * cy - by * cx);
+	};
+
+	const __m128 zero = _mm_setzero_ps();
+	size_t visible = 0;
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		const int* polygon = indices + i * INDICES_COUNT;
+
+		const auto gather = [&](const float* values, const int& vertex)
+		{
+			return _mm_setr_ps(values[polygon[vertex]], values[polygon[INDICES_COUNT + vertex]], values[polygon[INDICES_COUNT * 2 + vertex]], values[polygon[INDICES_COUNT * 3 + vertex]]);
+		};
+
+		const __m128 aw = gather(w, 0);
+		const __m128 bw = gather(w, 1);
+		const __m128 cw = gather(w, 2);
+
+		const __m128 ax = _mm_mul_ps(gather(x, 0), aw);
+		const __m128 ay = _mm_mul_ps(gather(y, 0), aw);
+		const __m128 bx = _mm_mul_ps(gather(x, 1), bw);
+		const __m128 by = _mm_mul_ps(gather(y, 1), bw);
+		const __m128 cx = _mm_mul_ps(gather(x, 2), cw);
+		const __m128 cy = _mm_mul_ps(gather(y, 2), cw);
+
+		const __m128 determinant = _mm_add_ps(_mm_sub_ps(
+			_mm_mul_ps(ax, _mm_sub_ps(_mm_mul_ps(by, cw), _mm_mul_ps(bw, cy))),
+			_mm_mul_ps(ay, _mm_sub_ps(_mm_mul_ps(bx, cw), _mm_mul_ps(bw, cx)))),
+			_mm_mul_ps(aw, _mm_sub_ps(_mm_mul_ps(bx, cy), _mm_mul_ps(by, cx))));
+
+		// Not less or equal, so that NaN is kept.
+		const int mask = _mm_movemask_ps(_mm_cmpnle_ps(determinant, zero));
+
+		// Every polygon is written, but only visible ones move the end along.
+		for (int j = 0; j < 4; ++j)
 		{
-			_visiblePolygons.push_back(&polygon);
+			_visiblePolygons[visible] = &_polygons[i + j];
+			visible += (mask >> j) & 1;
 		}
 	}
+
+	// Remaining polygons, one at a time...
+	for (; i < count; ++i)
+	{
+		_visiblePolygons[visible] = &_polygons[i];
+		visible += !(getDeterminant(i) <= 0) ? 1 : 0;
+	}
+
+	_visiblePolygons.resize(visible);
 }
 
 //
-// Sorts polygons from furthest away to closest.
+// Sorts polygons from furthest away to closest, or from closest to furthest
+// away if frontToBack is set.
 //
-void Mesh::CalculateDepthSorting(const std::vector<Vertex>& vertices)
+void Mesh::CalculateDepthSorting(const VertexBuffer& vertices, const bool& frontToBack)
 {
 	for (Polygon3D* polygon : _visiblePolygons)
 	{
 		polygon->CalculateDepth(vertices);
 	}
 
-	std::sort(_visiblePolygons.begin(), _visiblePolygons.end(), DepthTest());
+	if (frontToBack)
+	{
+		std::sort(_visiblePolygons.begin(), _visiblePolygons.end(), FrontToBackDepthTest());
+	}
+	else
+	{
+		std::sort(_visiblePolygons.begin(), _visiblePolygons.end(), DepthTest());
+	}
 }
 
 //
 // Draws a single polygon.
 //
-void Mesh::DrawSolidPolygon(const Polygon3D& polygon, const std::vector<Vertex>& clipSpace, const std::vector<Vertex>& worldSpace, const HDC& hdc)
+void Mesh::DrawSolidPolygon(const Polygon3D& polygon, const VertexBuffer& clipSpace, const VertexBuffer& worldSpace, const HDC& hdc)
 {
-	Vertex a = clipSpace[polygon.GetVertex(0)];
-	Vertex b = clipSpace[polygon.GetVertex(1)];
-	Vertex c = clipSpace[polygon.GetVertex(2)];
+	const Vector3 a = clipSpace.GetPosition(polygon.GetVertex(0));
+	const Vector3 b = clipSpace.GetPosition(polygon.GetVertex(1));
+	const Vector3 c = clipSpace.GetPosition(polygon.GetVertex(2));
 
 	POINT points[3]
 	{ 
@@ -404,7 +843,7 @@ void Mesh::DrawSolidPolygon(const Polygon3D& polygon, const std::vector<Vertex>&
 	};
 
 	// Compute final colour
-	Colour lighting = ComputeLighting(polygon, worldSpace);
+	Colour lighting = ComputeLighting(polygon, GetWorldNormal(polygon), worldSpace);
 	Colour finalColour = GetColour() * lighting;
 
 	SetActiveColour(hdc, finalColour.AsColor());
@@ -415,14 +854,14 @@ void Mesh::DrawSolidPolygon(const Polygon3D& polygon, const std::vector<Vertex>&
 //
 // Draws a polygon as a wireframe.
 //
-void Mesh::DrawWirePolygon(const Polygon3D& polygon, const std::vector<Vertex>& clipSpace, const std::vector<Vertex>& worldSpace, const HDC& hdc)
+void Mesh::DrawWirePolygon(const Polygon3D& polygon, const VertexBuffer& clipSpace, const VertexBuffer& worldSpace, const HDC& hdc)
 {
-	Vertex a = clipSpace[polygon.GetVertex(0)];
-	Vertex b = clipSpace[polygon.GetVertex(1)];
-	Vertex c = clipSpace[polygon.GetVertex(2)];
+	const Vector3 a = clipSpace.GetPosition(polygon.GetVertex(0));
+	const Vector3 b = clipSpace.GetPosition(polygon.GetVertex(1));
+	const Vector3 c = clipSpace.GetPosition(polygon.GetVertex(2));
 
 	// Compute final colour
-	Colour lighting = ComputeLighting(polygon, worldSpace);
+	Colour lighting = ComputeLighting(polygon, GetWorldNormal(polygon), worldSpace);
 	Colour finalColour = GetColour() * lighting;
 
 	SetActiveColour(hdc, finalColour.AsColor());
@@ -437,59 +876,121 @@ void Mesh::DrawWirePolygon(const Polygon3D& polygon, const std::vector<Vertex>&
 }
 
 //
-// Draws a polygon fragment by fragment.
+// Draws a polygon fragment by fragment. Polygons entirely off-screen or
+// behind the camera are skipped, and those crossing the near plane or
+// reaching past the guard band are clipped first.
 //
-void Mesh::DrawFragPolygon(const Polygon3D& polygon, const std::vector<Vertex>& clipSpace, const std::vector<Vertex>& worldSpace, const HDC& hdc)
+void Mesh::DrawFragPolygon(const Polygon3D& polygon, const VertexBuffer& clipSpace, const VertexBuffer& worldSpace, const FrameBuffer& target)
 {
-	const int& posIndex0 = polygon.GetVertex(0);
-	const int& posIndex1 = polygon.GetVertex(1);
-	const int& posIndex2 = polygon.GetVertex(2);
+	const Clipper::ClipResult result = _clipper.Classify(clipSpace, polygon.GetVertex(0), polygon.GetVertex(1), polygon.GetVertex(2));
 
-	const int& uvsIndex0 = polygon.GetUVCoord(0);
-	const int& uvsIndex1 = polygon.GetUVCoord(1);
-	const int& uvsIndex2 = polygon.GetUVCoord(2);
+	if (result == Clipper::ClipResult::CLIP_OUTSIDE)
+	{
+		return;
+	}
 
-	Vertex clipA(clipSpace[posIndex0]);
-	Vertex clipB(clipSpace[posIndex1]);
-	Vertex clipC(clipSpace[posIndex2]);
+	Vertex clip[3];
+	Vertex world[3];
 
-	const Vertex& worldA = worldSpace[posIndex0];
-	const Vertex& worldB = worldSpace[posIndex1];
-	const Vertex& worldC = worldSpace[posIndex2];
+	GetFragVertices(polygon, clipSpace, worldSpace, clip, world);
 
-	if (_uv.size())
+	if (result == Clipper::ClipResult::CLIP_INSIDE)
 	{
-		clipA.GetVertexData().SetUV(_uv[uvsIndex0]);
-		clipB.GetVertexData().SetUV(_uv[uvsIndex1]);
-		clipC.GetVertexData().SetUV(_uv[uvsIndex2]);
+		DrawFragTriangle(polygon, clip[0], clip[1], clip[2], world[0], world[1], world[2], target);
+		return;
 	}
 
-	// Draw using custom rasterizing system.
-	switch (_shadeMode)
+	ClippedPolygon clipped;
+	const int count = _clipper.Clip(clip, world, clipped);
+
+	// What is left is convex, so it can be drawn as a fan around its first vertex.
+	for (int i = 1; i + 1 < count; ++i)
 	{
-	case ShadeMode::SHADE_FLAT:
+		DrawFragTriangle(polygon, clipped.clipSpace[0], clipped.clipSpace[i], clipped.clipSpace[i + 1], clipped.worldSpace[0], clipped.worldSpace[i], clipped.worldSpace[i + 1], target);
+	}
+}
+
+//
+// Gathers the clip and world space vertices of a polygon, setting the UVs of
+// its clip space vertices.
+//
+void Mesh::GetFragVertices(const Polygon3D& polygon, const VertexBuffer& clipSpace, const VertexBuffer& worldSpace, Vertex (&clip)[3], Vertex (&world)[3]) const
+{
+	for (int i = 0; i < INDICES_COUNT; ++i)
 	{
-		Colour lighting = ComputeLighting(polygon, worldSpace);
-		Colour finalColour = GetColour() * lighting;
+		clip[i] = clipSpace.GetVertex(polygon.GetVertex(i));
+		world[i] = worldSpace.GetVertex(polygon.GetVertex(i));
 
-		SetActiveColour(hdc, finalColour.AsColor());
-		TriangleRasteriser::DrawFlat(hdc, { clipA, clipB, clipC });
-		ResetActiveColour(hdc);
+		if (_uv.size())
+		{
+			clip[i].GetVertexData().SetUV(_uv[polygon.GetUVCoord(i)]);
+		}
+	}
+}
 
+//
+// Rasterises a single triangle fragment by fragment.
+//
+void Mesh::DrawFragTriangle(const Polygon3D& polygon, const Vertex& clipA, const Vertex& clipB, const Vertex& clipC, const Vertex& worldA, const Vertex& worldB, const Vertex& worldC, const FrameBuffer& target)
+{
+	// Draw using custom rasterizing system.
+	switch (_shadeMode)
+	{
+	case ShadeMode::SHADE_FLAT:
+		// Lighting per-polygon was calculated before this function was called.
+		if (_rasterEngine == RasterEngine::ENGINE_HALFSPACE)
+		{
+			HalfSpaceRasteriser::DrawFlat(target, { clipA, clipB, clipC }, polygon.GetColour());
+		}
+		else
+		{
+			TriangleRasteriser::DrawFlat(target, { clipA, clipB, clipC }, polygon.GetColour());
+		}
 		break;
-	}
+
 	case ShadeMode::SHADE_GOURAUD:
 		// Lighting per-vertex was calculated before this function was called.
-		TriangleRasteriser::DrawSmooth(hdc, { clipA, clipB, clipC });
+		if (_rasterEngine == RasterEngine::ENGINE_HALFSPACE)
+		{
+			HalfSpaceRasteriser::DrawSmooth(target, { clipA, clipB, clipC });
+		}
+		else
+		{
+			TriangleRasteriser::DrawSmooth(target, { clipA, clipB, clipC });
+		}
 		break;
 
+	case ShadeMode::SHADE_DEFERRED:
+		if (_deferredMaterial != GBuffer::NO_MATERIAL)
+		{
+			Deferred frag(Environment::GetActive().GetGBuffer(), target, _texture, _textureFilter, GetColour(), _deferredMaterial);
+
+			if (_rasterEngine == RasterEngine::ENGINE_HALFSPACE)
+			{
+				HalfSpaceRasteriser::DrawPhong(target, { clipA, clipB, clipC }, { worldA, worldB, worldC }, frag);
+			}
+			else
+			{
+				TriangleRasteriser::DrawPhong(target, { clipA, clipB, clipC }, { worldA, worldB, worldC }, frag);
+			}
+			break;
+		}
+		[[fallthrough]];
+
 	case ShadeMode::SHADE_PHONG:
 	{
-		Phong frag(_ambient, _roughness, _specular, _texture, GetColour());
-//		Unlit frag(_texture);	// <- Use this for unlit graphics (faster).
+		Phong frag(_ambient, _roughness, _specular, _texture, _textureFilter, GetColour(), Environment::GetActive().GetLightGrid(), _doVectorising);
+//		Unlit frag(_texture, _textureFilter);	// <- Use this for unlit graphics (faster).
 
 		// Lighting will be calculated per-fragment, so we do not need to compute the lighting here.
-		TriangleRasteriser::DrawPhong(hdc, { clipA, clipB, clipC }, { worldA, worldB, worldC }, frag);
+		if (_rasterEngine == RasterEngine::ENGINE_HALFSPACE)
+		{
+			HalfSpaceRasteriser::DrawPhong(target, { clipA, clipB, clipC }, { worldA, worldB, worldC }, frag);
+		}
+		else
+		{
+			TriangleRasteriser::DrawPhong(target, { clipA, clipB, clipC }, { worldA, worldB, worldC }, frag);
+		}
 	}
 	default:
 		// Invalid operation.
@@ -498,22 +999,72 @@ void Mesh::DrawFragPolygon(const Polygon3D& polygon, const std::vector<Vertex>&
 }
 
 //
-// Computes all lighting to be applied to the polygon.
+// Draws every visible polygon fragment by fragment, sorting them into screen
+// tiles first so that the tiles can be rasterised in parallel. Each worker only
+// ever writes within its own tile, and polygons keep their order within a
+// tile, so the result matches drawing them one after the other.
 //
-Colour Mesh::ComputeLighting(const Polygon3D& polygon, const std::vector<Vertex>& vertices)
+void Mesh::DrawFragBinned(const VertexBuffer& clipSpace, const VertexBuffer& worldSpace, const FrameBuffer& target)
 {
-	const Vertex position = polygon.CalculateCenter(vertices);
-	const Vector3& normal = polygon.GetWorldNormal();
+	_binner.Reset(target);
 
-	const std::vector<LightPtr>& sceneLights = Environment::GetActive().GetSceneLights();
-	Colour totalLightContributions;
+	ClippedPolygon clipped;
 
-	for (const LightPtr& light : sceneLights)
+	for (const Polygon3D* polygon : _visiblePolygons)
 	{
-		totalLightContributions += light->CalculateContribution(position, normal, Colour::White, 0.f, 1.f); // Flat shading
+		switch (_clipper.Classify(clipSpace, polygon->GetVertex(0), polygon->GetVertex(1), polygon->GetVertex(2)))
+		{
+		case Clipper::ClipResult::CLIP_INSIDE:
+			_binner.Insert(polygon, clipSpace.GetPosition(polygon->GetVertex(0)), clipSpace.GetPosition(polygon->GetVertex(1)), clipSpace.GetPosition(polygon->GetVertex(2)));
+			break;
+
+		case Clipper::ClipResult::CLIP_CLIPPED:
+		{
+			// Bin what is left after clipping, the tiles clip the polygon again when drawing it.
+			Vertex clip[3];
+			Vertex world[3];
+
+			GetFragVertices(*polygon, clipSpace, worldSpace, clip, world);
+
+			if (_clipper.Clip(clip, world, clipped) >= 3)
+			{
+				_binner.Insert(polygon, clipped);
+			}
+			break;
+		}
+
+		default:
+			break;
+		}
 	}
 
-	return totalLightContributions;
+	ThreadPool::Get().ParallelFor(_binner.GetTileCount(), [&](const size_t& index)
+	{
+		const std::vector<const Polygon3D*>& tile = _binner.GetTile(index);
+
+		if (tile.empty())
+		{
+			return;
+		}
+
+		const FrameBuffer region = _binner.GetTileRegion(index);
+
+		for (const Polygon3D* polygon : tile)
+		{
+			DrawFragPolygon(*polygon, clipSpace, worldSpace, region);
+		}
+	});
+}
+
+//
+// Computes all lighting to be applied to the polygon.
+//
+Colour Mesh::ComputeLighting(const Polygon3D& polygon, const Vector3& normal, const VertexBuffer& vertices)
+{
+	const Vertex position = polygon.CalculateCenter(vertices);
+
+	// Flat shading
+	return Environment::GetActive().GetLightGrid().GetAllLights().Evaluate(position, normal, Colour::White, 0.f, 1.f);
 }
 
 //
@@ -523,15 +1074,7 @@ Colour Mesh::ComputeLighting(const Vertex& vertex, const Colour& ambient, const
 {
 	const Vector3& normal = vertex.GetVertexData().GetNormal();
 
-	const std::vector<LightPtr>& sceneLights = Environment::GetActive().GetSceneLights();
-	Colour totalLightContributions;
-
-	for (const LightPtr& light : sceneLights)
-	{
-		totalLightContributions += light->CalculateContribution(vertex, normal, ambient, roughness, specular);
-	}
-
-	return totalLightContributions;
+	return Environment::GetActive().GetLightGrid().GetAllLights().Evaluate(vertex, normal, ambient, roughness, specular);
 }
 
 //
@@ -551,23 +1094,87 @@ Texture& Mesh::GetTexture()
 }
 
 //
-// Computes lighting on a per-vertex basis on every vertex of this object.
+// Computes flat lighting for every visible polygon of this object.
+//
+void Mesh::ComputePolygonLighting()
+{
+	const VertexBuffer& worldVertices = GetWorldSpaceVertices();
+
+	for (Polygon3D* polygon : _visiblePolygons)
+	{
+		polygon->SetColour(GetColour() * ComputeLighting(*polygon, GetWorldNormal(*polygon), worldVertices));
+	}
+}
+
+//
+// Computes lighting on a per-vertex basis on the vertices of the visible
+// polygons. The colours are kept in the clip-space vertices from one frame to
+// the next, and only lit again when the mesh was transformed, its material
+// changed, or the lights which can reach it did. Vertices are lit in batches
+// across the worker threads.
 //
 void Mesh::ComputeVertexLighting()
 {
-	const std::vector<Vertex>& worldVertices = GetWorldSpaceVertices();
-	std::vector<Colour> vertexColours;
+	// Lights are compared against the (camera space) vertices they light.
+	BoundingSphere bounds{ Vector3(0, 0, 0), FLT_MAX };
 
-	for (const Vertex& vertex : worldVertices)
+	if (HasBounds())
 	{
-		vertexColours.push_back(GetColour() * ComputeLighting(vertex, _ambient, _roughness, _specular));
+		const Camera* const mainCamera = Camera::GetMainCamera();
+
+		bounds = mainCamera ? GetWorldSphere().Transform(mainCamera->GetConstants().view) : GetWorldSphere();
 	}
 
+	Environment::GetActive().GetLightGrid().GetLights(bounds, _frameLights);
+
+	const Colour colour = GetColour();
+
+	if (_areVertexColoursValid && _frameLights == _vertexLights && colour == _litColour && _ambient == _litAmbient && _roughness == _litRoughness && _specular == _litSpecular)
+	{
+		return;
+	}
+
+	std::swap(_vertexLights, _frameLights);
+
+	_litColour = colour;
+	_litAmbient = _ambient;
+	_litRoughness = _roughness;
+	_litSpecular = _specular;
+	_areVertexColoursValid = true;
+
+	const VertexBuffer& worldVertices = GetWorldSpaceVertices();
+
 	// Apply vertex colours to clip-space vertices.
-	std::vector<Vertex>& clipVertices = GetClipSpaceVertices();
+	VertexBuffer& clipVertices = GetClipSpaceVertices();
+
+	_isVertexLit.assign(worldVertices.GetCount(), false);
+	_litVertices.clear();
 
-	for (size_t i = 0; i < clipVertices.size(); ++i)
+	for (const Polygon3D* polygon : _visiblePolygons)
 	{
-		clipVertices[i].GetVertexData().SetColour(vertexColours[i]);
+		for (int i = 0; i < INDICES_COUNT; ++i)
+		{
+			const int index = polygon->GetVertex(i);
+
+			if (!_isVertexLit[index])
+			{
+				_isVertexLit[index] = true;
+				_litVertices.push_back(index);
+			}
+		}
 	}
+
+	const size_t batches = (_litVertices.size() + VERTEX_LIGHTING_BATCH - 1) / VERTEX_LIGHTING_BATCH;
+
+	ThreadPool::Get().ParallelFor(batches, [&](const size_t& batch)
+	{
+		const size_t end = min((batch + 1) * VERTEX_LIGHTING_BATCH, _litVertices.size());
+
+		for (size_t i = batch * VERTEX_LIGHTING_BATCH; i < end; ++i)
+		{
+			const Vertex vertex = worldVertices.GetVertex(_litVertices[i]);
+
+			clipVertices.SetColour(_litVertices[i], colour * _vertexLights.Evaluate(vertex, vertex.GetVertexData().GetNormal(), _ambient, _roughness, _specular));
+		}
+	});
 }
@@ -2,9 +2,17 @@
 #include "Shape.h"
 #include "Vertex.h"
 #include "Polygon3D.h"
+#include "Light.h"
 #include "Colour.h"
 #include "TriangleRasteriser.h"
+#include "HalfSpaceRasteriser.h"
 #include "Texture.h"
+#include "TileBinner.h"
+#include "Clipper.h"
+#include "FragmentBlock.h"
+#include "GBuffer.h"
+#include "KeyframeStore.h"
+#include <string>
 
 
 //
@@ -31,15 +39,25 @@ public:
 	{
 		SHADE_FLAT,
 		SHADE_GOURAUD,
-		SHADE_PHONG
+		SHADE_PHONG,
+		SHADE_DEFERRED	// Phong, lit once per visible pixel after the whole scene is drawn.
+	};
+
+	//
+	// Which rasteriser fills fragment drawn triangles.
+	//
+	enum class RasterEngine
+	{
+		ENGINE_SCANLINE,	// Top/bottom flat split, walked line by line.
+		ENGINE_HALFSPACE	// Edge functions, walked in blocks.
 	};
 
 
 	Mesh();
 	~Mesh();
 
-	// Loads the mesh data from a file.
-	void LoadFromFile(const char* const fileName, const char* texture = nullptr);
+	// Loads the mesh data from a file, or from the cache built the first time it was loaded.
+	void LoadFromFile(const char* const fileName, const char* texture = nullptr, const bool& useCache = true);
 
 	//
 	// Accessors
@@ -54,6 +72,24 @@ public:
 	void AddPolygon(int i0, int i1, int i2, int u0, int u1, int u2);
 	void AddUVcoord(float u, float v);
 
+	//
+	// Bulk modifiers, taking over the given data.
+	//
+	void SetPolygons(std::vector<Polygon3D>&& polygons);
+	void SetUVcoords(std::vector<Vector3>&& uvs);
+	void SetKeyframes(KeyframeStore&& keyframes);
+
+	//
+	// Keyframe animation. Animations loop over a range of frames, or over the
+	// frames of the given name, which returns false if there are none.
+	//
+	void PlayAnimation(const int& firstFrame, const int& lastFrame, const float& framesPerSecond);
+	const bool PlayAnimation(const std::string& name, const float& framesPerSecond);
+	void StopAnimation();
+	void Animate(const float& deltaTime);
+
+	const KeyframeStore& GetKeyframes() const;
+
 	//
 	// Draw operation
 	//
@@ -64,7 +100,12 @@ public:
 	//
 	void Mode(const DrawMode& mode);
 	void Shade(const ShadeMode& mode);
+	void Engine(const RasterEngine& engine);
+	void Filter(const TextureFilter& filter);
 	void Cull(const bool& mode);
+	void DepthSort(const bool& mode);
+	void Bin(const bool& mode);
+	void Vectorise(const bool& mode);
 
 	//
 	// Shading information.
@@ -87,7 +128,7 @@ public:
 	//
 	// Lighting tools
 	//
-	static Colour ComputeLighting(const Polygon3D& polygon, const std::vector<Vertex>& vertices);
+	static Colour ComputeLighting(const Polygon3D& polygon, const Vector3& normal, const VertexBuffer& vertices);
 	static Colour ComputeLighting(const Vertex& vertex, const Colour& ambient, const float& roughness, const float& specular);
 
 	//
@@ -97,6 +138,8 @@ public:
 	Texture& GetTexture();
 
 private:
+	friend class MeshCache;
+
 	//
 	// Pen handler
 	//
@@ -107,46 +150,102 @@ private:
 	// Normals
 	//
 	void GenerateObjectNormals();
-	void GenerateWorldNormals();
-	void GenerateClipNormals();
-	void GenerateVertexNormals();
+	const Vector3& GetWorldNormal(const Polygon3D& polygon) const;
+
+	//
+	// Interpolates the vertices for the current point of the animation.
+	//
+	void UpdatePose();
 
 	//
 	// Optimisation tools
 	//
-	void CalculateBackfaceCulling(const std::vector<Vertex>& vertices);
-	void CalculateDepthSorting(const std::vector<Vertex>& polygons);
+	void CalculateBackfaceCulling(const VertexBuffer& vertices);
+	void CalculateDepthSorting(const VertexBuffer& vertices, const bool& frontToBack = false);
 	
 	//
 	// Drawing tools
 	//
-	void DrawSolidPolygon(const Polygon3D& polygon, const std::vector<Vertex>& clipSpace, const std::vector<Vertex>& worldSpace, const HDC& hdc);
-	void DrawWirePolygon(const Polygon3D& polygon, const std::vector<Vertex>& clipSpace, const std::vector<Vertex>& worldSpace, const HDC& hdc);
-	void DrawFragPolygon(const Polygon3D& polygon, const std::vector<Vertex>& clipSpace, const std::vector<Vertex>& worldSpace, const HDC& hdc);
+	void DrawSolidPolygon(const Polygon3D& polygon, const VertexBuffer& clipSpace, const VertexBuffer& worldSpace, const HDC& hdc);
+	void DrawWirePolygon(const Polygon3D& polygon, const VertexBuffer& clipSpace, const VertexBuffer& worldSpace, const HDC& hdc);
+	void DrawFragPolygon(const Polygon3D& polygon, const VertexBuffer& clipSpace, const VertexBuffer& worldSpace, const FrameBuffer& target);
+	void DrawFragTriangle(const Polygon3D& polygon, const Vertex& clipA, const Vertex& clipB, const Vertex& clipC, const Vertex& worldA, const Vertex& worldB, const Vertex& worldC, const FrameBuffer& target);
+	void DrawFragBinned(const VertexBuffer& clipSpace, const VertexBuffer& worldSpace, const FrameBuffer& target);
+
+	//
+	// Gathers the clip and world space vertices of a polygon, along with their UVs.
+	//
+	void GetFragVertices(const Polygon3D& polygon, const VertexBuffer& clipSpace, const VertexBuffer& worldSpace, Vertex (&clip)[3], Vertex (&world)[3]) const;
 
 	//
 	// Lighting tools
 	//
-	void ComputeVertexLighting(); // Computes the lighting for all vertices.
+	void ComputePolygonLighting(); // Computes the flat lighting for all visible polygons.
+	void ComputeVertexLighting(); // Computes the lighting for the vertices of all visible polygons, when it changed.
+
+	//
+	// Vertices lit by each worker thread task.
+	//
+	static constexpr size_t VERTEX_LIGHTING_BATCH = 256;
 
 private:
 	std::vector<Polygon3D> _polygons;
 	std::vector<Polygon3D*> _visiblePolygons;
+	std::vector<int> _indices;			// Vertex indices of every polygon, three at a time, for the backface culling kernel.
 	std::vector<Vector3> _uv;
+	std::vector<Vector3> _faceNormals;		// Model-space normal of every polygon, in the same order.
+	std::vector<Vector3> _worldFaceNormals;	// The same normals, as of the last time the mesh was transformed.
+	std::vector<Vector3> _vertexNormals;	// Smooth normals being generated, kept to save reallocating them every pose.
 
 	HPEN _previousPen;
 	HBRUSH _previousBrush;
 
 	DrawMode _drawMode;
 	ShadeMode _shadeMode;
+	RasterEngine _rasterEngine{ RasterEngine::ENGINE_SCANLINE };
+	TextureFilter _textureFilter{ TextureFilter::FILTER_MIPMAP };
 
 	Texture _texture;
 
+	//
+	// Keyframes, and the animation looping over them. The pose is only
+	// interpolated when the mesh is drawn after the animation moved on.
+	//
+	KeyframeStore _keyframes;
+	int _firstFrame{ 0 };
+	int _lastFrame{ 0 };
+	float _framesPerSecond{ 0 };
+	float _animationTime{ 0 };
+	bool _isPoseValid{ true };
+
 	float _roughness;	// Alpha
 	float _specular;	// Ks
 	Colour _ambient;	// Ka
 //	Colour _colour;		// Kd, this is included in Shape and it is essentially its functionality.
 
 	bool _doBackfaceCulling{ true };
+	bool _doDepthSorting{ false };
+	bool _doBinning{ false };
+	bool _doVectorising{ true };
+
+	int _deferredMaterial{ GBuffer::NO_MATERIAL };	// Index of this frame's material in the G-buffer, if drawn deferred.
+
+	//
+	// Everything the vertex colours were last lit with. They are kept until the
+	// mesh is transformed again, or any of these changes.
+	//
+	bool _areVertexColoursValid{ false };
+	LightBuffer _vertexLights;			// Lights which could reach the mesh.
+	LightBuffer _frameLights;			// The same, for the frame being drawn.
+	Colour _litColour;
+	Colour _litAmbient;
+	float _litRoughness{ 0 };
+	float _litSpecular{ 0 };
+
+	std::vector<int> _litVertices;		// Vertices of the visible polygons, each once.
+	std::vector<bool> _isVertexLit;
+
+	TileBinner _binner;
+	Clipper _clipper;
 };
 
@@ -0,0 +1,481 @@
+#include "MeshCache.h"
+#include "Mesh.h"
+#include "MappedFile.h"
+#include <fstream>
+#include <vector>
+#include <cstring>
+#include <climits>
+#include <string>
+
+// Magic number for mesh caches "MSHC"
+const UINT32 MESH_CACHE_IDENT = (('C' << 24) + ('H' << 16) + ('S' << 8) + 'M');
+
+// Cache version, to be increased whenever the layout changes so that every
+// cache is rebuilt.
+const UINT32 MESH_CACHE_VERSION = 4;
+
+// Every array starts on a 16 byte boundary of the file.
+const UINT64 MESH_CACHE_ALIGNMENT = 16;
+
+// Size and last write time of a file a cache was built from.
+struct MeshCacheSource
+{
+	UINT64 size;
+	UINT64 time;
+};
+
+struct MeshCacheHeader
+{
+	UINT32 ident;                 // The magic number used to identify the file.
+	UINT32 version;               // The version of the layout.
+	MeshCacheSource model;        // The model file the cache was built from.
+	MeshCacheSource texture;      // The texture file the cache was built from.
+	char textureName[MAX_PATH];   // The name the texture was loaded by, empty if none.
+	INT32 vertexCount;            // The number of vertices.
+	INT32 polygonCount;           // The number of polygons.
+	INT32 uvCount;                // The number of texture coordinates.
+	INT32 frameCount;             // The number of keyframes.
+	INT32 frameStride;            // The number of packed vertices stored per keyframe.
+	INT32 textureWidth;           // The width of the texture, 0 if none was loaded.
+	INT32 textureHeight;          // The height of the texture.
+	INT32 hasBounds;              // Whether the bounds below were calculated.
+	float bounds[6];              // Model-space bounding box (minimum, maximum).
+	float sphere[4];              // Model-space bounding sphere (centre, radius).
+	float keyframeBounds[6];      // Bounding box of every keyframe.
+};
+
+struct MeshCacheFrame
+{
+	float scale[3];         // Scale values, Y up
+	float translate[3];     // Translation vector, Y up
+	char name[16];          // Frame name
+};
+
+// Where each array lies within the file, which follows from the header alone.
+struct MeshCacheLayout
+{
+	UINT64 x;
+	UINT64 y;
+	UINT64 z;
+	UINT64 normals;
+	UINT64 faceNormals;
+	UINT64 polygons;
+	UINT64 uvs;
+	UINT64 frames;
+	UINT64 keyframes;
+	UINT64 texture;
+	UINT64 palette;
+	UINT64 texels;
+	UINT64 end;
+};
+
+// Every polygon is stored as its three vertex indices, then its three UV indices.
+const int POLYGON_INDICES = INDICES_COUNT * 2;
+
+static const MeshCacheLayout GetLayout(const MeshCacheHeader& header)
+{
+	MeshCacheLayout layout;
+	UINT64 offset = sizeof(MeshCacheHeader);
+
+	const auto place = [&](const UINT64& size)
+	{
+		const UINT64 start = (offset + MESH_CACHE_ALIGNMENT - 1) / MESH_CACHE_ALIGNMENT * MESH_CACHE_ALIGNMENT;
+		offset = start + size;
+
+		return start;
+	};
+
+	const UINT64 vertexCount = static_cast<UINT64>(header.vertexCount);
+	const UINT64 polygonCount = static_cast<UINT64>(header.polygonCount);
+	const UINT64 texels = static_cast<UINT64>(header.textureWidth) * static_cast<UINT64>(header.textureHeight);
+	const UINT64 tiledTexels = texels > 0 ? Texture::GetTexelCount(header.textureWidth, header.textureHeight) : 0;
+
+	layout.x = place(sizeof(float) * vertexCount);
+	layout.y = place(sizeof(float) * vertexCount);
+	layout.z = place(sizeof(float) * vertexCount);
+	layout.normals = place(sizeof(float) * 3 * vertexCount);
+	layout.faceNormals = place(sizeof(float) * 3 * polygonCount);
+	layout.polygons = place(sizeof(INT32) * POLYGON_INDICES * polygonCount);
+	layout.uvs = place(sizeof(float) * 2 * static_cast<UINT64>(header.uvCount));
+	layout.frames = place(sizeof(MeshCacheFrame) * static_cast<UINT64>(header.frameCount));
+	layout.keyframes = place(sizeof(UINT32) * static_cast<UINT64>(header.frameStride) * static_cast<UINT64>(header.frameCount));
+	layout.texture = place(texels);
+	layout.palette = place(texels > 0 ? sizeof(COLORREF) * 256 : 0);
+	layout.texels = place(sizeof(UINT32) * tiledTexels);
+	layout.end = offset;
+
+	return layout;
+}
+
+// Size and last write time of a file, returns false if there is no such file.
+static const bool GetSource(const char* const fileName, MeshCacheSource& source)
+{
+	source = { 0, 0 };
+
+	WIN32_FILE_ATTRIBUTE_DATA data;
+
+	if (!fileName || !GetFileAttributesExA(fileName, GetFileExInfoStandard, &data))
+	{
+		return false;
+	}
+
+	source.size = (static_cast<UINT64>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+	source.time = (static_cast<UINT64>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+
+	return true;
+}
+
+// Whether an existing file differs from the one a cache was built from.
+static const bool HasChanged(const char* const fileName, const MeshCacheSource& built)
+{
+	MeshCacheSource source;
+
+	return GetSource(fileName, source) && (source.size != built.size || source.time != built.time);
+}
+
+const std::string MeshCache::GetCacheName(const char* const modelFilename)
+{
+	std::string name(modelFilename);
+
+	const size_t extension = name.find_last_of('.');
+	const size_t directory = name.find_last_of("/\\");
+
+	if (extension != std::string::npos && (directory == std::string::npos || extension > directory))
+	{
+		name.erase(extension);
+	}
+
+	return name + ".mesh";
+}
+
+// Load mesh from cache.
+//
+// The header and the whole layout are validated, along with every polygon's
+// indices, before anything is handed over to the mesh. The arrays are then
+// copied straight out of the mapped file.
+
+const bool MeshCache::Load(const char* const cacheFilename, const char* const modelFilename, const char* const textureFilename, Mesh& mesh)
+{
+	MappedFile file;
+
+	if (!file.Open(cacheFilename))
+	{
+		return false;
+	}
+
+	const MeshCacheHeader* header = file.Get<MeshCacheHeader>(0);
+
+	if (!header || header->ident != MESH_CACHE_IDENT || header->version != MESH_CACHE_VERSION)
+	{
+		return false;
+	}
+
+	// Built from another texture, or from files which have changed since.
+	const char* const textureName = textureFilename ? textureFilename : "";
+
+	if (!memchr(header->textureName, 0, MAX_PATH) || strcmp(header->textureName, textureName) != 0 ||
+		HasChanged(modelFilename, header->model) || HasChanged(textureFilename, header->texture))
+	{
+		return false;
+	}
+
+	const int vertexCount = header->vertexCount;
+	const int polygonCount = header->polygonCount;
+	const int uvCount = header->uvCount;
+	const int frameCount = header->frameCount;
+	const int textureWidth = header->textureWidth;
+	const int textureHeight = header->textureHeight;
+
+	if (vertexCount < 0 || polygonCount < 0 || uvCount < 0 || frameCount < 0 || textureWidth < 0 || textureHeight < 0)
+	{
+		return false;
+	}
+
+	// Arrays reaching past the end of the file
+	const MeshCacheLayout layout = GetLayout(*header);
+
+	if (layout.end > file.GetSize() || layout.end > INT_MAX)
+	{
+		return false;
+	}
+
+	KeyframeStore keyframes;
+	keyframes.Reset(vertexCount, frameCount);
+
+	if (header->frameStride != keyframes._stride)
+	{
+		return false;
+	}
+
+	const float* x = file.Get<float>(static_cast<int>(layout.x), vertexCount);
+	const float* y = file.Get<float>(static_cast<int>(layout.y), vertexCount);
+	const float* z = file.Get<float>(static_cast<int>(layout.z), vertexCount);
+	const float* normals = file.Get<float>(static_cast<int>(layout.normals), vertexCount * 3);
+	const float* faceNormals = file.Get<float>(static_cast<int>(layout.faceNormals), polygonCount * 3);
+	const INT32* indices = file.Get<INT32>(static_cast<int>(layout.polygons), polygonCount * POLYGON_INDICES);
+	const float* uvCoords = file.Get<float>(static_cast<int>(layout.uvs), uvCount * 2);
+	const MeshCacheFrame* frames = file.Get<MeshCacheFrame>(static_cast<int>(layout.frames), frameCount);
+	const UINT32* packed = file.Get<UINT32>(static_cast<int>(layout.keyframes), header->frameStride * frameCount);
+
+	// Polygon array initialization
+	std::vector<Polygon3D> polygons;
+	polygons.reserve(polygonCount);
+
+	for (int i = 0; i < polygonCount; ++i)
+	{
+		const INT32* vertexIndex = indices + i * POLYGON_INDICES;
+		const INT32* uvIndex = vertexIndex + INDICES_COUNT;
+
+		for (int j = 0; j < INDICES_COUNT; ++j)
+		{
+			if (vertexIndex[j] < 0 || vertexIndex[j] >= vertexCount ||
+				(uvCount > 0 && (uvIndex[j] < 0 || uvIndex[j] >= uvCount)))
+			{
+				return false;
+			}
+		}
+
+		polygons.emplace_back(vertexIndex[0], vertexIndex[1], vertexIndex[2], uvIndex[0], uvIndex[1], uvIndex[2]);
+	}
+
+	// Vertex array initialization
+	VertexBuffer vertices;
+	vertices.Resize(vertexCount);
+
+	memcpy(vertices.GetX(), x, sizeof(float) * vertexCount);
+	memcpy(vertices.GetY(), y, sizeof(float) * vertexCount);
+	memcpy(vertices.GetZ(), z, sizeof(float) * vertexCount);
+
+	std::vector<Vector3> vertexNormals;
+	vertexNormals.reserve(vertexCount);
+
+	for (int i = 0; i < vertexCount; ++i)
+	{
+		vertexNormals.emplace_back(normals[i * 3], normals[i * 3 + 1], normals[i * 3 + 2]);
+	}
+
+	std::vector<Vector3> polygonNormals;
+	polygonNormals.reserve(polygonCount);
+
+	for (int i = 0; i < polygonCount; ++i)
+	{
+		polygonNormals.emplace_back(faceNormals[i * 3], faceNormals[i * 3 + 1], faceNormals[i * 3 + 2]);
+	}
+
+	// Texture coordinates initialisation
+	std::vector<Vector3> uvs;
+	uvs.reserve(uvCount);
+
+	for (int i = 0; i < uvCount; ++i)
+	{
+		uvs.emplace_back(uvCoords[i * 2], uvCoords[i * 2 + 1], 0.f);
+	}
+
+	// Keyframe initialization
+	for (int i = 0; i < frameCount; ++i)
+	{
+		KeyframeStore::Keyframe& keyframe = keyframes._frames[i];
+
+		memcpy(keyframe.scale, frames[i].scale, sizeof(keyframe.scale));
+		memcpy(keyframe.translate, frames[i].translate, sizeof(keyframe.translate));
+		keyframe.name.assign(frames[i].name, strnlen(frames[i].name, sizeof(frames[i].name)));
+	}
+
+	memcpy(keyframes._vertices.data(), packed, sizeof(UINT32) * keyframes._vertices.size());
+
+	keyframes._bounds = { { header->keyframeBounds[0], header->keyframeBounds[1], header->keyframeBounds[2] }, { header->keyframeBounds[3], header->keyframeBounds[4], header->keyframeBounds[5] } };
+
+	// Texture initialisation, already decoded.
+	if (textureWidth > 0 && textureHeight > 0)
+	{
+		Texture& texture = mesh.GetTexture();
+		texture.SetTextureSize(textureWidth, textureHeight);
+
+		memcpy(texture.GetPaletteIndices(), file.GetData() + layout.texture, static_cast<size_t>(textureWidth) * textureHeight);
+		memcpy(texture.GetPalette(), file.GetData() + layout.palette, sizeof(COLORREF) * 256);
+		memcpy(texture.GetTexels(), file.GetData() + layout.texels, sizeof(UINT32) * Texture::GetTexelCount(textureWidth, textureHeight));
+	}
+
+	mesh.SetVertices(std::move(vertices));
+	mesh.SetNormals(vertexNormals);
+	mesh.SetPolygons(std::move(polygons));
+	mesh._faceNormals = std::move(polygonNormals);
+	mesh._uv = std::move(uvs);
+	mesh._keyframes = std::move(keyframes);
+
+	if (header->hasBounds)
+	{
+		const BoundingBox bounds{ { header->bounds[0], header->bounds[1], header->bounds[2] }, { header->bounds[3], header->bounds[4], header->bounds[5] } };
+		const BoundingSphere sphere{ { header->sphere[0], header->sphere[1], header->sphere[2] }, header->sphere[3] };
+
+		mesh.SetBounds(bounds, sphere);
+	}
+
+	return true;
+}
+
+// Save mesh to cache.
+//
+// Every array is flattened into plain floats and integers first, and then
+// written at the offset the layout gives it. The cache is written to a file
+// of its own first, and only moved over the cache once it is complete, so a
+// cache is never seen half written, even when several threads save the same
+// mesh at once.
+
+const bool MeshCache::Save(const char* const cacheFilename, const char* const modelFilename, const char* const textureFilename, const Mesh& mesh)
+{
+	const char* const textureName = textureFilename ? textureFilename : "";
+
+	if (strlen(textureName) >= MAX_PATH)
+	{
+		return false;
+	}
+
+	const VertexBuffer& vertices = mesh.GetVertices();
+	const KeyframeStore& keyframes = mesh._keyframes;
+	const Texture& texture = mesh.GetTexture();
+
+	const int vertexCount = static_cast<int>(vertices.GetCount());
+	const int polygonCount = static_cast<int>(mesh._polygons.size());
+
+	if (vertices.GetNormals().size() != vertices.GetCount() || mesh._faceNormals.size() != mesh._polygons.size())
+	{
+		return false;
+	}
+
+	MeshCacheHeader header;
+	memset(&header, 0, sizeof(header));
+
+	header.ident = MESH_CACHE_IDENT;
+	header.version = MESH_CACHE_VERSION;
+
+	GetSource(modelFilename, header.model);
+	GetSource(textureFilename, header.texture);
+	memcpy(header.textureName, textureName, strlen(textureName) + 1);
+
+	header.vertexCount = vertexCount;
+	header.polygonCount = polygonCount;
+	header.uvCount = static_cast<INT32>(mesh._uv.size());
+	header.frameCount = keyframes.GetFrameCount();
+	header.frameStride = keyframes._stride;
+
+	// Textures which failed to load have no UVs to sample them with.
+	if (texture.GetPaletteIndices() && !mesh._uv.empty())
+	{
+		header.textureWidth = static_cast<INT32>(texture.GetWidth());
+		header.textureHeight = static_cast<INT32>(texture.GetHeight());
+	}
+
+	header.hasBounds = mesh.HasBounds() ? 1 : 0;
+
+	const BoundingBox& bounds = mesh.GetLocalBounds();
+	const BoundingSphere& sphere = mesh.GetLocalSphere();
+	const BoundingBox& keyframeBounds = keyframes.GetBounds();
+
+	const float boundsValues[6]{ bounds.minimum.GetX(), bounds.minimum.GetY(), bounds.minimum.GetZ(), bounds.maximum.GetX(), bounds.maximum.GetY(), bounds.maximum.GetZ() };
+	const float sphereValues[4]{ sphere.centre.GetX(), sphere.centre.GetY(), sphere.centre.GetZ(), sphere.radius };
+	const float keyframeValues[6]{ keyframeBounds.minimum.GetX(), keyframeBounds.minimum.GetY(), keyframeBounds.minimum.GetZ(), keyframeBounds.maximum.GetX(), keyframeBounds.maximum.GetY(), keyframeBounds.maximum.GetZ() };
+
+	memcpy(header.bounds, boundsValues, sizeof(header.bounds));
+	memcpy(header.sphere, sphereValues, sizeof(header.sphere));
+	memcpy(header.keyframeBounds, keyframeValues, sizeof(header.keyframeBounds));
+
+	// Normals, polygons, UVs and frames flattened into the layout of the file.
+	std::vector<float> normals;
+	normals.reserve(static_cast<size_t>(vertexCount) * 3);
+
+	for (const Vector3& normal : vertices.GetNormals())
+	{
+		normals.insert(normals.end(), { normal.GetX(), normal.GetY(), normal.GetZ() });
+	}
+
+	std::vector<float> faceNormals;
+	faceNormals.reserve(static_cast<size_t>(polygonCount) * 3);
+
+	for (const Vector3& normal : mesh._faceNormals)
+	{
+		faceNormals.insert(faceNormals.end(), { normal.GetX(), normal.GetY(), normal.GetZ() });
+	}
+
+	std::vector<INT32> indices;
+	indices.reserve(static_cast<size_t>(polygonCount) * POLYGON_INDICES);
+
+	for (const Polygon3D& polygon : mesh._polygons)
+	{
+		indices.insert(indices.end(), { polygon.GetVertex(0), polygon.GetVertex(1), polygon.GetVertex(2), polygon.GetUVCoord(0), polygon.GetUVCoord(1), polygon.GetUVCoord(2) });
+	}
+
+	std::vector<float> uvs;
+	uvs.reserve(mesh._uv.size() * 2);
+
+	for (const Vector3& uv : mesh._uv)
+	{
+		uvs.insert(uvs.end(), { uv.GetX(), uv.GetY() });
+	}
+
+	std::vector<MeshCacheFrame> frames(keyframes.GetFrameCount());
+
+	for (size_t i = 0; i < frames.size(); ++i)
+	{
+		const KeyframeStore::Keyframe& keyframe = keyframes._frames[i];
+
+		memset(&frames[i], 0, sizeof(MeshCacheFrame));
+		memcpy(frames[i].scale, keyframe.scale, sizeof(keyframe.scale));
+		memcpy(frames[i].translate, keyframe.translate, sizeof(keyframe.translate));
+		memcpy(frames[i].name, keyframe.name.c_str(), min(keyframe.name.size(), sizeof(frames[i].name)));
+	}
+
+	// Named after the process and thread writing it, so that no two saves share it.
+	const std::string temporaryFilename = std::string(cacheFilename) + "." + std::to_string(GetCurrentProcessId()) + "." + std::to_string(GetCurrentThreadId()) + ".tmp";
+
+	std::ofstream file;
+
+	file.open(temporaryFilename, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (file.fail())
+	{
+		return false;
+	}
+
+	const MeshCacheLayout layout = GetLayout(header);
+	UINT64 position = 0;
+
+	// Pads up to the array's offset, then writes it.
+	const auto write = [&](const UINT64& offset, const void* data, const size_t& size)
+	{
+		const char padding[MESH_CACHE_ALIGNMENT]{};
+
+		file.write(padding, static_cast<std::streamsize>(offset - position));
+		file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+
+		position = offset + size;
+	};
+
+	write(0, &header, sizeof(header));
+	write(layout.x, vertices.GetX(), sizeof(float) * vertexCount);
+	write(layout.y, vertices.GetY(), sizeof(float) * vertexCount);
+	write(layout.z, vertices.GetZ(), sizeof(float) * vertexCount);
+	write(layout.normals, normals.data(), sizeof(float) * normals.size());
+	write(layout.faceNormals, faceNormals.data(), sizeof(float) * faceNormals.size());
+	write(layout.polygons, indices.data(), sizeof(INT32) * indices.size());
+	write(layout.uvs, uvs.data(), sizeof(float) * uvs.size());
+	write(layout.frames, frames.data(), sizeof(MeshCacheFrame) * frames.size());
+	write(layout.keyframes, keyframes._vertices.data(), sizeof(UINT32) * keyframes._vertices.size());
+
+	if (header.textureWidth > 0)
+	{
+		write(layout.texture, texture.GetPaletteIndices(), static_cast<size_t>(header.textureWidth) * header.textureHeight);
+		write(layout.palette, texture.GetPalette(), sizeof(COLORREF) * 256);
+		write(layout.texels, texture.GetTexels(), sizeof(UINT32) * Texture::GetTexelCount(texture.GetWidth(), texture.GetHeight()));
+	}
+
+	file.close();
+
+	// Fails while a loader has the cache mapped, which leaves that one in place.
+	if (file.fail() || !MoveFileExA(temporaryFilename.c_str(), cacheFilename, MOVEFILE_REPLACE_EXISTING))
+	{
+		DeleteFileA(temporaryFilename.c_str());
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <Windows.h>
+#include <string>
+
+class Mesh;
+
+//
+// Binary cache of a loaded mesh, holding everything the renderer keeps of it
+// once it has been parsed and prepared: positions, vertex and polygon normals,
+// polygons, UVs, bounds, keyframes and the decoded texture. Every array is
+// stored exactly as the mesh keeps it in memory, so loading is a single
+// mapping of the file and a copy of each array, with nothing to parse or
+// calculate.
+//
+// Caches remember the size and write time of the model and texture they were
+// built from, and are rebuilt whenever either changes. Caches whose model is
+// missing are still loaded, so that they can be shipped on their own.
+//
+class MeshCache
+{
+public:
+	//
+	// The cache file kept for a model: the model's name, with the extension
+	// replaced by ".mesh".
+	//
+	static const std::string GetCacheName(const char* const modelFilename);
+
+	//
+	// Loads the mesh from the cache file. Returns false, leaving the mesh as it
+	// is, if the cache is missing, of another version, or out of date.
+	//
+	static const bool Load(const char* const cacheFilename, const char* const modelFilename, const char* const textureFilename, Mesh& mesh);
+
+	//
+	// Writes the loaded mesh into the cache file. Returns false if it cannot
+	// be written.
+	//
+	static const bool Save(const char* const cacheFilename, const char* const modelFilename, const char* const textureFilename, const Mesh& mesh);
+};
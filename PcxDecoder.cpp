@@ -0,0 +1,181 @@
+#include "PcxDecoder.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstring>
+
+// Palette colours at the end of the file, after a marker byte.
+const size_t PCX_PALETTE_SIZE = 256 * 3;
+const BYTE PCX_PALETTE_MARKER = 12;
+
+// Bytes with both top bits set start a run, repeating the next byte.
+const BYTE PCX_RUN_FLAG = 0xC0;
+const BYTE PCX_RUN_LENGTH = 0x3F;
+
+struct PcxHeader
+{
+	BYTE  ID;
+	BYTE  Version;
+	BYTE  Encoding;
+	BYTE  BitsPerPixel;
+	short XMin;
+	short YMin;
+	short XMax;
+	short YMax;
+	short HRes;
+	short VRes;
+	BYTE  ClrMap[16 * 3];
+	BYTE  Reserved;
+	BYTE  NumPlanes;
+	short BytesPerLine;
+	short Pal;
+	BYTE  Filler[58];
+};
+
+//
+// Maps the file, and decodes it straight from the mapped pages.
+//
+const bool PcxDecoder::Load(const char* const fileName, Texture& texture)
+{
+	MappedFile file;
+
+	if (!file.Open(fileName))
+	{
+		return false;
+	}
+
+	return Decode(file.GetData(), file.GetSize(), texture);
+}
+
+//
+// Reads the palette first, so that pixels can be expanded as they are
+// decoded. Scanlines may be padded past the width of the image, and runs may
+// carry on from one scanline into the next, so the position is kept within
+// the padded scanline and only the visible part of each run is written.
+//
+const bool PcxDecoder::Decode(const BYTE* data, const size_t& size, Texture& texture)
+{
+	if (!data || size < sizeof(PcxHeader) + PCX_PALETTE_SIZE + 1)
+	{
+		return false;
+	}
+
+	const PcxHeader* header = reinterpret_cast<const PcxHeader*>(data);
+
+	// We only handle those with 256 colour palette
+	if (header->Version != 5 || header->BitsPerPixel != 8 || header->Encoding != 1 || header->NumPlanes != 1)
+	{
+		return false;
+	}
+
+	const int width = header->XMax - header->XMin + 1;
+	const int height = header->YMax - header->YMin + 1;
+	const int bytesPerLine = header->BytesPerLine;
+
+	const BYTE* rawPalette = data + size - PCX_PALETTE_SIZE;
+
+	if (width <= 0 || height <= 0 || bytesPerLine < width || rawPalette[-1] != PCX_PALETTE_MARKER)
+	{
+		return false;
+	}
+
+	texture.SetTextureSize(width, height);
+
+	COLORREF* palette = texture.GetPalette();
+	UINT32 texelPalette[256];
+
+	for (int i = 0; i < 256; ++i)
+	{
+		const BYTE red = rawPalette[i * 3];
+		const BYTE green = rawPalette[i * 3 + 1];
+		const BYTE blue = rawPalette[i * 3 + 2];
+
+		palette[i] = RGB(red, green, blue);
+		texelPalette[i] = (static_cast<UINT32>(red) << 16) | (static_cast<UINT32>(green) << 8) | blue;
+	}
+
+	BYTE* indices = texture.GetPaletteIndices();
+	UINT32* texels = texture.GetTexels();
+
+	const BYTE* stream = data + sizeof(PcxHeader);
+	const BYTE* const streamEnd = rawPalette - 1;
+
+	int row = 0;
+	int column = 0;
+
+	while (row < height)
+	{
+		if (stream == streamEnd)
+		{
+			// Data stops short of the image
+			return false;
+		}
+
+		BYTE value = *stream++;
+		int count = 1;
+
+		if ((value & PCX_RUN_FLAG) == PCX_RUN_FLAG)
+		{
+			if (stream == streamEnd)
+			{
+				return false;
+			}
+
+			count = value & PCX_RUN_LENGTH;
+			value = *stream++;
+		}
+
+		// Single bytes are by far the most common, and need no fills.
+		if (count == 1 && column < width)
+		{
+			indices[static_cast<size_t>(row) * width + column] = value;
+			texels[texture.GetTexelOffset(column, row)] = texelPalette[value];
+
+			if (++column == bytesPerLine)
+			{
+				column = 0;
+				++row;
+			}
+
+			continue;
+		}
+
+		while (count > 0)
+		{
+			if (row == height)
+			{
+				// Run reaching past the end of the image
+				return false;
+			}
+
+			const int span = min(count, bytesPerLine - column);
+			const int visible = min(column + span, width) - column;
+
+			if (visible > 0)
+			{
+				memset(indices + static_cast<size_t>(row) * width + column, value, visible);
+
+				// Texels are only contiguous within the row of a tile.
+				for (int x = column; x < column + visible;)
+				{
+					const int length = min(column + visible - x, Texture::TILE_SIZE - (x & Texture::TILE_MASK));
+
+					std::fill_n(texels + texture.GetTexelOffset(x, row), length, texelPalette[value]);
+					x += length;
+				}
+			}
+
+			count -= span;
+			column += span;
+
+			if (column == bytesPerLine)
+			{
+				column = 0;
+				++row;
+			}
+		}
+	}
+
+	texture.GenerateMipmaps();
+
+	return true;
+}
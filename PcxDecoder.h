@@ -0,0 +1,29 @@
+#pragma once
+#include <Windows.h>
+#include "Texture.h"
+
+//
+// Decodes PCX images into textures. Only 8-bit, single plane, RLE encoded
+// images with a 256 colour palette are supported, which is what MD2 skins are.
+//
+// The whole file is mapped and decoded in a single pass: runs are written as
+// bulk fills, and every pixel is expanded into its 32-bit texel (in the tiled
+// layout the texture samples from) as its palette index is written. Mip
+// levels are built from the texels once the whole image is decoded. Files
+// whose runs reach past the end of the image, or whose data stops short of
+// it, are rejected.
+//
+class PcxDecoder
+{
+public:
+	//
+	// Decodes the file into the texture, which is sized to the image. Returns
+	// false if it cannot be read, or is not a supported PCX image.
+	//
+	static const bool Load(const char* const fileName, Texture& texture);
+
+	//
+	// Decodes a whole PCX file already in memory.
+	//
+	static const bool Decode(const BYTE* data, const size_t& size, Texture& texture);
+};
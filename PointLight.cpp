@@ -1,6 +1,7 @@
 #include "PointLight.h"
 #include "Camera.h"
 #include <algorithm>
+#include <cfloat>
 
 //
 // Default point light constructor.
@@ -81,3 +82,22 @@ Colour PointLight::CalculateContribution(const Vertex& position, const Vector3&
 
 	return GetIntensity() * (finalIntensity + phongHighlights);
 }
+
+//
+// The sphere around the light, up to where its attenuation brings it below
+// the cutoff. Highlights are not attenuated, so they are dropped past it too.
+//
+const bool PointLight::GetBounds(BoundingSphere& bounds) const
+{
+	bounds = { _position, GetRange(_attenuation) };
+
+	return bounds.radius < FLT_MAX;
+}
+
+//
+// Adds the light to the point light arrays of a packed light buffer.
+//
+void PointLight::Pack(LightBuffer& buffer)
+{
+	buffer.AddPoint(GetIntensity(), _position, _attenuation);
+}
@@ -28,6 +28,17 @@ public:
 	//
 	Colour CalculateContribution(const Vertex& position, const Vector3& normal, const Colour& ambient, const float& roughness, const float& specular) override;
 
+	//
+	// The sphere around the light, up to where its attenuation brings it below
+	// the cutoff.
+	//
+	const bool GetBounds(BoundingSphere& bounds) const override;
+
+	//
+	// Adds the light to the point light arrays of a packed light buffer.
+	//
+	void Pack(LightBuffer& buffer) override;
+
 private:
 	Vector3 _position;
 	float _attenuation;
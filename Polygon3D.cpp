@@ -39,9 +39,6 @@ Polygon3D::Polygon3D(const Polygon3D& other) : _vertices{ 0 }
 	_uvcoords[2] = other._uvcoords[2];
 	_depth = other._depth;
 	_finalColour = other._finalColour;
-	_objectNormal = other._objectNormal;
-	_worldNormal = other._worldNormal;
-	_clipNormal = other._clipNormal;
 }
 
 //
@@ -70,30 +67,6 @@ int Polygon3D::GetUVCoord(const int& i) const
 	return _uvcoords[i];
 }
 
-//
-// This polygon's precalculated OBJECT SPACE normal.
-//
-const Vector3& Polygon3D::GetObjectNormal() const
-{
-	return _objectNormal;
-}
-
-//
-// This polygon's precalculated OBJECT SPACE normal.
-//
-const Vector3& Polygon3D::GetWorldNormal() const
-{
-	return _worldNormal;
-}
-
-//
-// This polygon's precalculated OBJECT SPACE normal.
-//
-const Vector3& Polygon3D::GetClipNormal() const
-{
-	return _clipNormal;
-}
-
 //
 // The depth of this polygon.
 //
@@ -111,72 +84,50 @@ const Colour& Polygon3D::GetColour() const
 }
 
 //
-// Calculates the center of the polygon.
+// Sets the calculated colour of this polygon.
 //
-const Vertex Polygon3D::CalculateCenter(const std::vector<Vertex>& vertices) const
+void Polygon3D::SetColour(const Colour& colour)
 {
-	const Vertex& a = vertices[_vertices[0]];
-	const Vertex& b = vertices[_vertices[1]];
-	const Vertex& c = vertices[_vertices[2]];
-
-	return Vertex::GetAverage(a, b, c);
+	_finalColour = colour;
 }
 
 //
-// Calculates the average depth of all vertices in the polygon.
-//
-void Polygon3D::CalculateDepth(const std::vector<Vertex>& vertices)
-{
-	const Vertex& a = vertices[_vertices[0]];
-	const Vertex& b = vertices[_vertices[1]];
-	const Vertex& c = vertices[_vertices[2]];
-
-	_depth = (a.GetDepth() + b.GetDepth() + c.GetDepth()) / 3;
-}
-
-//
-// Calculates the OBJECT SPACE normal for this polygon.
+// Calculates the center of the polygon.
 //
-void Polygon3D::CalculateObjectNormal(const std::vector<Vertex>& objectSpace)
+const Vertex Polygon3D::CalculateCenter(const VertexBuffer& vertices) const
 {
-	const Vertex& a = objectSpace[_vertices[0]];
-	const Vertex& b = objectSpace[_vertices[1]];
-	const Vertex& c = objectSpace[_vertices[2]];
+	const float* x = vertices.GetX();
+	const float* y = vertices.GetY();
+	const float* z = vertices.GetZ();
+	const float* w = vertices.GetW();
 
-	Vector3 aTob((b - a).AsVector());
-	Vector3 aToc((c - a).AsVector());
+	const int& a = _vertices[0];
+	const int& b = _vertices[1];
+	const int& c = _vertices[2];
 
-	_objectNormal = Vector3::NormaliseVector(Vector3::Cross(aTob, aToc));
+	return Vertex((x[a] + x[b] + x[c]) / 3, (y[a] + y[b] + y[c]) / 3, (z[a] + z[b] + z[c]) / 3, (w[a] + w[b] + w[c]) / 3);
 }
 
 //
-// Calculates the WORLD SPACE normal for this polygon.
+// Calculates the average depth of all vertices in the polygon.
 //
-void Polygon3D::CalculateWorldNormal(const std::vector<Vertex>& worldSpace)
+void Polygon3D::CalculateDepth(const VertexBuffer& vertices)
 {
-	const Vertex& a = worldSpace[_vertices[0]];
-	const Vertex& b = worldSpace[_vertices[1]];
-	const Vertex& c = worldSpace[_vertices[2]];
-
-	Vector3 aTob((b - a).AsVector());
-	Vector3 aToc((c - a).AsVector());
+	const float* depth = vertices.GetDepth();
 
-	_worldNormal = Vector3::NormaliseVector(Vector3::Cross(aTob, aToc));
+	_depth = (depth[_vertices[0]] + depth[_vertices[1]] + depth[_vertices[2]]) / 3;
 }
 
 //
-// Calculates the CLIP SPACE normal for this polygon.
+// Calculates the normal of this polygon from the positions of its vertices.
 //
-void Polygon3D::CalculateClipNormal(const std::vector<Vertex>& clipSpace)
+const Vector3 Polygon3D::CalculateNormal(const VertexBuffer& vertices) const
 {
-	const Vertex& a = clipSpace[_vertices[0]];
-	const Vertex& b = clipSpace[_vertices[1]];
-	const Vertex& c = clipSpace[_vertices[2]];
+	const Vector3 a = vertices.GetPosition(_vertices[0]);
+	const Vector3 b = vertices.GetPosition(_vertices[1]);
+	const Vector3 c = vertices.GetPosition(_vertices[2]);
 
-	Vector3 aTob((b - a).AsVector());
-	Vector3 aToc((c - a).AsVector());
-
-	_clipNormal = Vector3::NormaliseVector(Vector3::Cross(aTob, aToc));
+	return Vector3::NormaliseVector(Vector3::Cross(b - a, c - a));
 }
 
 //
@@ -191,9 +142,6 @@ Polygon3D& Polygon3D::operator=(const Polygon3D& rhs)
 	_uvcoords[1] = rhs._uvcoords[1];
 	_uvcoords[2] = rhs._uvcoords[2];
 	_depth = rhs._depth;
-	_objectNormal = rhs._objectNormal;
-	_worldNormal = rhs._worldNormal;
-	_clipNormal = rhs._clipNormal;
 	_finalColour = rhs._finalColour;
 
 	return *this;
@@ -222,3 +170,11 @@ const bool DepthTest::operator()(Polygon3D* lhs, Polygon3D* rhs) const
 {
 	return *lhs > *rhs;
 }
+
+//
+// Compares the depth of two polygons, closest first.
+//
+const bool FrontToBackDepthTest::operator()(Polygon3D* lhs, Polygon3D* rhs) const
+{
+	return *lhs < *rhs;
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "Vector.h"
 #include "Vertex.h"
+#include "VertexBuffer.h"
 #include "Colour.h"
 #include <vector>
 
@@ -31,19 +32,18 @@ public:
 	int GetVertex(const int& i) const;
 	int GetUVCoord(const int& i) const;
 
-	const Vector3& GetObjectNormal() const;
-	const Vector3& GetWorldNormal() const;
-	const Vector3& GetClipNormal() const;
-
 	const float& GetDepth() const;
 	const Colour& GetColour() const;
+	void SetColour(const Colour& colour);
 
-	const Vertex CalculateCenter(const std::vector<Vertex>& vertices) const;
-	void CalculateDepth(const std::vector<Vertex>& vertices);
+	const Vertex CalculateCenter(const VertexBuffer& vertices) const;
+	void CalculateDepth(const VertexBuffer& vertices);
 
-	void CalculateObjectNormal(const std::vector<Vertex>& objectSpace);
-	void CalculateWorldNormal(const std::vector<Vertex>& worldSpace);
-	void CalculateClipNormal(const std::vector<Vertex>& clipSpace);
+	//
+	// The normal of the polygon in the space of the given vertices. Meshes keep
+	// their normals in their own arrays, this is only for when they are built.
+	//
+	const Vector3 CalculateNormal(const VertexBuffer& vertices) const;
 
 	Polygon3D& operator=(const Polygon3D& rhs);
 
@@ -56,10 +56,6 @@ private:
 
 	float _depth;
 	Colour _finalColour;
-
-	Vector3 _objectNormal;
-	Vector3 _worldNormal;
-	Vector3 _clipNormal;
 };
 
 
@@ -67,6 +63,14 @@ private:
 // Compares the depth of two polygons
 //
 struct DepthTest
+{
+	const bool operator()(Polygon3D* lhs, Polygon3D* rhs) const;
+};
+
+//
+// Compares the depth of two polygons, closest first
+//
+struct FrontToBackDepthTest
 {
 	const bool operator()(Polygon3D* lhs, Polygon3D* rhs) const;
 };
\ No newline at end of file
@@ -16,6 +16,10 @@ void Presentation::OnInit()
 
 	_delay = 2.5f;
 
+	// Both meshes load in the background while the welcome text is shown.
+	_pedistalLoad = AssetLoader::Get().LoadMesh("Meshes/cube.md2", "lines.pcx");
+	_figurineLoad = AssetLoader::Get().LoadMesh("Meshes/marvin.md2", "marvin.pcx");
+
 	Camera::GetMainCamera()->SetPosition({ 0, 0, -50 });
 	Camera::GetMainCamera()->SetRotation({ 0, 0, 0 });
 }
@@ -100,14 +104,20 @@ void Presentation::BeginPhase(const float& deltaTime)
 
 	if (!_pedistal)
 	{
-		_pedistal = CreateShape<Mesh>();
-		_pedistal->LoadFromFile("Meshes/cube.md2", "lines.pcx");
+		// Wait for the cube, with the text up.
+		if (!AssetLoader::IsReady(_pedistalLoad))
+		{
+			return;
+		}
+
+		_pedistal = AddShape(_pedistalLoad.get());
 		_pedistal->SetColour(Colour::White);
 		_pedistal->Mode(Mesh::DrawMode::DRAW_WIREFRAME);
 		_pedistal->Shade(Mesh::ShadeMode::SHADE_FLAT); // For later...
 		_pedistal->SetPosition({ 0, -43.f, 0 });
 		_pedistal->SetScale({ 0, 0, 0 });
 		_pedistal->Cull(false);
+		_pedistal->Bin(true);
 	}
 	
 	Vector3 cubeScale = _pedistal->GetTransform().GetScale();
@@ -151,13 +161,18 @@ void Presentation::MarvinPhase(const float& deltaTime)
 
 	if (!_figurine)
 	{
-		_figurine = CreateShape<Mesh>();
-		_figurine->LoadFromFile("Meshes/marvin.md2", "marvin.pcx");
+		if (!AssetLoader::IsReady(_figurineLoad))
+		{
+			return;
+		}
+
+		_figurine = AddShape(_figurineLoad.get());
 		_figurine->SetColour(Colour::White);
 		_figurine->Mode(Mesh::DrawMode::DRAW_WIREFRAME);
 		_figurine->Shade(Mesh::ShadeMode::SHADE_FLAT); // For later...
 		_figurine->SetPosition({ 0, 100.f, 0 });
 		_figurine->Cull(false);
+		_figurine->Bin(true);
 	}
 
 	/* -- Drop phase -- */
@@ -6,6 +6,7 @@
 #include "PointLight.h"
 #include "AmbientLight.h"
 #include "SpotLight.h"
+#include "AssetLoader.h"
 
 //
 // Starts a presentation to showcase all features of the framework.
@@ -69,6 +70,10 @@ private:
 	Mesh* _pedistal{ nullptr };
 	Mesh* _figurine{ nullptr };
 
+	// Scene objects still being loaded, added to the scene once they are ready.
+	std::future<std::unique_ptr<Mesh>> _pedistalLoad;
+	std::future<std::unique_ptr<Mesh>> _figurineLoad;
+
 	AmbientLight* _ambient{ nullptr };
 	DirectionalLight* _directional{ nullptr };
 	PointLight* _point{ nullptr };
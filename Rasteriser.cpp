@@ -83,25 +83,13 @@ void Rasteriser::InitialiseComponents(const Bitmap& bitmap)
 }
 
 //
-// Clears the screen to a colour
+// Clears the screen to a colour (writes directly into the bitmap's colour buffer)
+// and resets the depth buffer.
 //
 void Rasteriser::Clear(const COLORREF& colour, const Bitmap& bitmap)
 {
-	HDC hdc = bitmap.GetDC();
-	RECT fillRect;
-
-	int width = bitmap.GetWidth();
-	int height = bitmap.GetHeight();
-
-	fillRect.left = 0;
-	fillRect.top = 0;
-
-	fillRect.right = width;
-	fillRect.bottom = height;
-	
-	HBRUSH brush = CreateSolidBrush(colour);
-	FillRect(hdc, &fillRect, brush);
-	DeleteObject(brush);
+	bitmap.Clear(colour);
+	bitmap.ClearDepth();
 }
 
 //
@@ -49,6 +49,36 @@ void SceneObject::Render(const HDC& hdc)
 	}
 }
 
+//
+// The world-space box around every shape of this object.
+//
+const bool SceneObject::GetWorldBounds(BoundingBox& bounds) const
+{
+	if (_shapes.empty())
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < _shapes.size(); ++i)
+	{
+		if (!_shapes[i]->HasBounds())
+		{
+			return false;
+		}
+
+		if (i == 0)
+		{
+			bounds = _shapes[i]->GetWorldBounds();
+		}
+		else
+		{
+			bounds.Encapsulate(_shapes[i]->GetWorldBounds());
+		}
+	}
+
+	return true;
+}
+
 //
 // Destroys a previously created shape.
 //
@@ -31,6 +31,12 @@ public:
 	//
 	void Render(const HDC& hdc);
 
+	//
+	// The world-space box around every shape of this object. Returns false
+	// when it cannot be bounded, as one of its shapes has no bounds.
+	//
+	const bool GetWorldBounds(BoundingBox& bounds) const;
+
 	//
 	// Full equality operator.
 	//
@@ -41,6 +47,8 @@ public:
 	//
 	template <class TShapeType>
 	TShapeType* const CreateShape();
+	template <class TShapeType>
+	TShapeType* const AddShape(std::unique_ptr<TShapeType>&& shape);
 	void DestroyShape(const Shape& shape);
 
 protected:
@@ -68,3 +76,17 @@ inline TShapeType* const SceneObject::CreateShape()
 
 	return createdShape;
 }
+
+//
+// Takes over a shape created elsewhere, such as one loaded in the background.
+//
+template<class TShapeType>
+inline TShapeType* const SceneObject::AddShape(std::unique_ptr<TShapeType>&& shape)
+{
+	static_assert(std::is_base_of<Shape, TShapeType>::value, "Invalid type being added as a shape object!");
+
+	TShapeType* const addedShape = shape.get();
+	_shapes.push_back(std::move(shape));
+
+	return addedShape;
+}
@@ -0,0 +1,385 @@
+#include "SceneTree.h"
+#include <cfloat>
+
+//
+// How much larger than their object leaves are, relative to the object's size.
+//
+constexpr float LEAF_MARGIN = .1f;
+
+//
+// The smallest box containing both boxes.
+//
+static const BoundingBox Combine(const BoundingBox& lhs, const BoundingBox& rhs)
+{
+	BoundingBox combined = lhs;
+	combined.Encapsulate(rhs);
+
+	return combined;
+}
+
+//
+// Adds an object with the given bounds, returns the leaf holding it.
+//
+const int SceneTree::Insert(SceneObject* const object, const BoundingBox& bounds)
+{
+	const int leaf = AllocateNode();
+
+	_nodes[leaf].bounds = bounds.Expand(bounds.GetExtents() * LEAF_MARGIN);
+	_nodes[leaf].objectBounds = bounds;
+	_nodes[leaf].object = object;
+
+	InsertLeaf(leaf);
+	++_count;
+
+	return leaf;
+}
+
+//
+// Removes an object from the tree.
+//
+void SceneTree::Remove(const int& leaf)
+{
+	RemoveLeaf(leaf);
+	FreeNode(leaf);
+	--_count;
+}
+
+//
+// Updates the bounds of an object. As long as they remain within its leaf
+// nothing else changes, otherwise the leaf is inserted again.
+//
+const bool SceneTree::Move(const int& leaf, const BoundingBox& bounds)
+{
+	Node& node = _nodes[leaf];
+	node.objectBounds = bounds;
+
+	if (node.bounds.Contains(bounds))
+	{
+		return false;
+	}
+
+	RemoveLeaf(leaf);
+
+	_nodes[leaf].bounds = bounds.Expand(bounds.GetExtents() * LEAF_MARGIN);
+
+	InsertLeaf(leaf);
+
+	return true;
+}
+
+//
+// Removes every object from the tree.
+//
+void SceneTree::Clear()
+{
+	_nodes.clear();
+	_freeNodes.clear();
+	_root = NULL_NODE;
+	_count = 0;
+}
+
+//
+// The amount of objects in the tree.
+//
+const size_t SceneTree::GetCount() const
+{
+	return _count;
+}
+
+//
+// Finds every object within the frustum. Once a node is found entirely within
+// it, none of the objects under it need to be tested.
+//
+void SceneTree::Query(const Frustum& frustum, std::vector<SceneObject*>& objects) const
+{
+	if (_root == NULL_NODE)
+	{
+		return;
+	}
+
+	_stack.clear();
+	_stack.push_back(_root);
+
+	while (!_stack.empty())
+	{
+		const int index = _stack.back();
+		const Node& node = _nodes[index];
+		_stack.pop_back();
+
+		if (node.IsLeaf())
+		{
+			if (frustum.Intersects(node.objectBounds))
+			{
+				objects.push_back(node.object);
+			}
+		}
+		else if (frustum.Contains(node.bounds))
+		{
+			AddObjects(index, objects);
+		}
+		else if (frustum.Intersects(node.bounds))
+		{
+			_stack.push_back(node.left);
+			_stack.push_back(node.right);
+		}
+	}
+}
+
+//
+// Finds every object overlapping the sphere.
+//
+void SceneTree::Query(const BoundingSphere& sphere, std::vector<SceneObject*>& objects) const
+{
+	if (_root == NULL_NODE)
+	{
+		return;
+	}
+
+	_stack.clear();
+	_stack.push_back(_root);
+
+	while (!_stack.empty())
+	{
+		const Node& node = _nodes[_stack.back()];
+		_stack.pop_back();
+
+		if (node.IsLeaf())
+		{
+			if (node.objectBounds.Intersects(sphere))
+			{
+				objects.push_back(node.object);
+			}
+		}
+		else if (node.bounds.Intersects(sphere))
+		{
+			_stack.push_back(node.left);
+			_stack.push_back(node.right);
+		}
+	}
+}
+
+//
+// The closest object whose bounds are hit by the ray. Nodes further away than
+// the closest hit found so far are skipped.
+//
+SceneObject* const SceneTree::Raycast(const Vector3& origin, const Vector3& direction, float& distance) const
+{
+	SceneObject* closest = nullptr;
+	distance = FLT_MAX;
+
+	if (_root == NULL_NODE)
+	{
+		return closest;
+	}
+
+	const Vector3 inverseDirection(1 / direction.GetX(), 1 / direction.GetY(), 1 / direction.GetZ());
+
+	_stack.clear();
+	_stack.push_back(_root);
+
+	while (!_stack.empty())
+	{
+		const Node& node = _nodes[_stack.back()];
+		_stack.pop_back();
+
+		float hit = 0;
+
+		if (!node.bounds.Raycast(origin, inverseDirection, hit) || hit >= distance)
+		{
+			continue;
+		}
+
+		if (!node.IsLeaf())
+		{
+			_stack.push_back(node.left);
+			_stack.push_back(node.right);
+		}
+		else if (node.objectBounds.Raycast(origin, inverseDirection, hit) && hit < distance)
+		{
+			closest = node.object;
+			distance = hit;
+		}
+	}
+
+	return closest;
+}
+
+//
+// Takes a node from the pool, or adds a new one if there are none left.
+//
+const int SceneTree::AllocateNode()
+{
+	if (_freeNodes.empty())
+	{
+		_nodes.push_back(Node());
+		return static_cast<int>(_nodes.size() - 1);
+	}
+
+	const int node = _freeNodes.back();
+	_freeNodes.pop_back();
+
+	_nodes[node] = Node();
+
+	return node;
+}
+
+//
+// Returns a node to the pool.
+//
+void SceneTree::FreeNode(const int& node)
+{
+	_nodes[node].object = nullptr;
+	_freeNodes.push_back(node);
+}
+
+//
+// Links a leaf into the tree. Walks down from the root towards whichever child
+// would grow the least by taking the leaf in, and stops where pairing the leaf
+// with the current node is cheaper than going any deeper (surface area
+// heuristic).
+//
+void SceneTree::InsertLeaf(const int& leaf)
+{
+	if (_root == NULL_NODE)
+	{
+		_root = leaf;
+		_nodes[leaf].parent = NULL_NODE;
+		return;
+	}
+
+	const BoundingBox bounds = _nodes[leaf].bounds;
+	int sibling = _root;
+
+	while (!_nodes[sibling].IsLeaf())
+	{
+		const Node& node = _nodes[sibling];
+
+		const float area = node.bounds.GetHalfArea();
+		const float combinedArea = Combine(node.bounds, bounds).GetHalfArea();
+
+		// Cost of pairing the leaf with this node, and the cost its ancestors
+		// pay to grow around the leaf whichever way it goes down.
+		const float cost = 2 * combinedArea;
+		const float inheritedCost = 2 * (combinedArea - area);
+
+		const auto getCost = [&](const int& child)
+		{
+			const Node& childNode = _nodes[child];
+			const float childCombinedArea = Combine(childNode.bounds, bounds).GetHalfArea();
+
+			if (childNode.IsLeaf())
+			{
+				return childCombinedArea + inheritedCost;
+			}
+
+			return childCombinedArea - childNode.bounds.GetHalfArea() + inheritedCost;
+		};
+
+		const float leftCost = getCost(node.left);
+		const float rightCost = getCost(node.right);
+
+		if (cost < leftCost && cost < rightCost)
+		{
+			break;
+		}
+
+		sibling = leftCost < rightCost ? node.left : node.right;
+	}
+
+	// Replace the sibling with a new parent holding both the sibling and the leaf.
+	const int oldParent = _nodes[sibling].parent;
+	const int newParent = AllocateNode();
+
+	_nodes[newParent].parent = oldParent;
+	_nodes[newParent].left = sibling;
+	_nodes[newParent].right = leaf;
+	_nodes[newParent].bounds = Combine(_nodes[sibling].bounds, bounds);
+
+	_nodes[sibling].parent = newParent;
+	_nodes[leaf].parent = newParent;
+
+	if (oldParent == NULL_NODE)
+	{
+		_root = newParent;
+		return;
+	}
+
+	if (_nodes[oldParent].left == sibling)
+	{
+		_nodes[oldParent].left = newParent;
+	}
+	else
+	{
+		_nodes[oldParent].right = newParent;
+	}
+
+	Refit(oldParent);
+}
+
+//
+// Unlinks a leaf from the tree. Its parent is freed, and its sibling takes
+// the parent's place.
+//
+void SceneTree::RemoveLeaf(const int& leaf)
+{
+	if (leaf == _root)
+	{
+		_root = NULL_NODE;
+		return;
+	}
+
+	const int parent = _nodes[leaf].parent;
+	const int grandParent = _nodes[parent].parent;
+	const int sibling = _nodes[parent].left == leaf ? _nodes[parent].right : _nodes[parent].left;
+
+	_nodes[sibling].parent = grandParent;
+	FreeNode(parent);
+
+	if (grandParent == NULL_NODE)
+	{
+		_root = sibling;
+		return;
+	}
+
+	if (_nodes[grandParent].left == parent)
+	{
+		_nodes[grandParent].left = sibling;
+	}
+	else
+	{
+		_nodes[grandParent].right = sibling;
+	}
+
+	Refit(grandParent);
+}
+
+//
+// Recalculates the bounds of the node and all of its ancestors.
+//
+void SceneTree::Refit(int node)
+{
+	while (node != NULL_NODE)
+	{
+		Node& current = _nodes[node];
+		current.bounds = Combine(_nodes[current.left].bounds, _nodes[current.right].bounds);
+
+		node = current.parent;
+	}
+}
+
+//
+// Adds the objects of every leaf under the node, without testing them.
+//
+void SceneTree::AddObjects(const int& node, std::vector<SceneObject*>& objects) const
+{
+	const Node& current = _nodes[node];
+
+	if (current.IsLeaf())
+	{
+		objects.push_back(current.object);
+		return;
+	}
+
+	AddObjects(current.left, objects);
+	AddObjects(current.right, objects);
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "Bounds.h"
+#include "Vector.h"
+#include <vector>
+
+// Forward declare scene objects
+class SceneObject;
+
+//
+// Dynamic bounding volume hierarchy over the world-space bounds of scene
+// objects. Every object sits in a leaf whose box is slightly larger than the
+// object itself, so that small movements leave the tree untouched. Objects
+// leaving their leaf are taken out and inserted again, next to whichever
+// node makes the tree grow the least.
+//
+class SceneTree
+{
+public:
+	//
+	// Index standing for no node at all.
+	//
+	static constexpr int NULL_NODE = -1;
+
+	//
+	// Adds an object with the given bounds, returns the leaf holding it.
+	//
+	const int Insert(SceneObject* const object, const BoundingBox& bounds);
+	void Remove(const int& leaf);
+
+	//
+	// Updates the bounds of an object. Returns whether its leaf had to be
+	// moved within the tree.
+	//
+	const bool Move(const int& leaf, const BoundingBox& bounds);
+
+	void Clear();
+
+	const size_t GetCount() const;
+
+	//
+	// Queries, adding every object found to the list.
+	//
+	void Query(const Frustum& frustum, std::vector<SceneObject*>& objects) const;
+	void Query(const BoundingSphere& sphere, std::vector<SceneObject*>& objects) const;
+
+	//
+	// The closest object whose bounds are hit by the ray, or null if there is
+	// none. The distance along the ray to where it is hit is written to distance.
+	//
+	SceneObject* const Raycast(const Vector3& origin, const Vector3& direction, float& distance) const;
+
+private:
+	//
+	// A node of the tree. Leaves hold an object, every other node has exactly
+	// two children and bounds containing both.
+	//
+	struct Node
+	{
+		BoundingBox bounds;				// Enlarged bounds, for leaves.
+		BoundingBox objectBounds;		// Exact bounds of the object, for leaves.
+		SceneObject* object{ nullptr };
+
+		int parent{ NULL_NODE };
+		int left{ NULL_NODE };
+		int right{ NULL_NODE };
+
+		inline const bool IsLeaf() const;
+	};
+
+	const int AllocateNode();
+	void FreeNode(const int& node);
+
+	void InsertLeaf(const int& leaf);
+	void RemoveLeaf(const int& leaf);
+
+	//
+	// Recalculates the bounds of the node and all of its ancestors.
+	//
+	void Refit(int node);
+
+	//
+	// Adds the objects of every leaf under the node, without testing them.
+	//
+	void AddObjects(const int& node, std::vector<SceneObject*>& objects) const;
+
+private:
+	std::vector<Node> _nodes;
+	std::vector<int> _freeNodes;
+	int _root{ NULL_NODE };
+	size_t _count{ 0 };
+
+	mutable std::vector<int> _stack;	// Nodes left to visit by queries.
+};
+
+//
+// Whether the node holds an object rather than two children.
+//
+inline const bool SceneTree::Node::IsLeaf() const
+{
+	return left == NULL_NODE;
+}
@@ -13,25 +13,59 @@ Shape::Shape() : _shapeColour(RGB(0, 0, 0))
 //
 Shape::~Shape()
 {
-	_shapeData.clear();
+	_shapeData.Clear();
 }
 
 //
-// Returns a vertex group containing every vertex in the internal shape, transformed by the MVP matrix.
+// Transforms the positions of every vertex in the internal shape into world
+// and clip space, in a single batched pass. Model-space normals are carried
+// into world space by the inverse transpose of the model-view matrix, the
+// other vertex attributes are never touched by the transforms.
 //
-void Shape::CalculateTransformations()
+// Nothing is recalculated unless the shape, the camera, or the vertices
+// changed since the last call, so static shapes cost no matrix work.
+//
+const bool Shape::CalculateTransformations()
 {
-	const size_t  verticesCount = _shapeData.size();
+	const Camera* const mainCamera = Camera::GetMainCamera();
+	const unsigned int cameraVersion = mainCamera ? mainCamera->GetConstants().version : 0;
 
-	Matrix mv = GetMVP(MV);
-	Matrix p = GetMVP(P);
-	Matrix p2c = GetP2C();
+	if (_isTransformed && _transformVersion == GetTransformVersion() && _cameraVersion == cameraVersion)
+	{
+		return false;
+	}
 
-	for (size_t i = 0; i < verticesCount; ++i)
+	if (mainCamera)
 	{
-		_worldSpaceData[i] = mv * _shapeData[i];
-		_clipSpaceData[i] = ObjectToClipSpace(p, p2c, _worldSpaceData[i]);
+		const CameraConstants& constants = mainCamera->GetConstants();
+
+		_modelView = constants.view * GetTransform();
+		_modelViewClip = constants.viewClip * GetTransform();
 	}
+	else
+	{
+		_modelView = GetTransform();
+		_modelViewClip = GetTransform();
+	}
+
+	_normalMatrix = _modelView.NormalMatrix();
+
+	Matrix::TransformBatch(_modelView, _modelViewClip, _shapeData, _worldSpaceData, _clipSpaceData);
+	Matrix::TransformNormals(_normalMatrix, _shapeData.GetNormals(), _worldSpaceData.GetNormals());
+
+	_transformVersion = GetTransformVersion();
+	_cameraVersion = cameraVersion;
+	_isTransformed = true;
+
+	return true;
+}
+
+//
+// The matrix normals were last transformed into world space by.
+//
+const Matrix& Shape::GetNormalMatrix() const
+{
+	return _normalMatrix;
 }
 
 //
@@ -69,25 +103,10 @@ const Matrix Shape::GetP2C() const
 	return Matrix::IdentityMatrix();
 }
 
-//
-// Applies the MVP transformation, dehomogenisation, and screen transformation.
-//
-const Vertex Shape::ObjectToClipSpace(const Matrix& p, const Matrix& p2c, const Vertex& vertex)
-{
-	Vertex transformed = p * vertex;
-	transformed.Dehomogenise();
-
-	// Apply projection-to-clip matrix...
-	transformed = p2c * transformed;
-
-
-	return transformed;
-}
-
 //
 // The fully tranformed vertices, after all projection and clip space transformations have been applied.
 //
-const std::vector<Vertex>& Shape::GetClipSpaceVertices() const
+const VertexBuffer& Shape::GetClipSpaceVertices() const
 {
 	return _clipSpaceData;
 }
@@ -95,7 +114,7 @@ const std::vector<Vertex>& Shape::GetClipSpaceVertices() const
 //
 // The world-space vertices without any projection/clip space transformation applied to them.
 //
-const std::vector<Vertex>& Shape::GetWorldSpaceVertices() const
+const VertexBuffer& Shape::GetWorldSpaceVertices() const
 {
 	return _worldSpaceData;
 }
@@ -103,7 +122,7 @@ const std::vector<Vertex>& Shape::GetWorldSpaceVertices() const
 //
 // The fully tranformed vertices, after all projection and clip space transformations have been applied.
 //
-std::vector<Vertex>& Shape::GetClipSpaceVertices()
+VertexBuffer& Shape::GetClipSpaceVertices()
 {
 	return _clipSpaceData;
 }
@@ -111,7 +130,7 @@ std::vector<Vertex>& Shape::GetClipSpaceVertices()
 //
 // The world-space vertices without any projection/clip space transformation applied to them.
 //
-std::vector<Vertex>& Shape::GetWorldSpaceVertices()
+VertexBuffer& Shape::GetWorldSpaceVertices()
 {
 	return _worldSpaceData;
 }
@@ -121,10 +140,12 @@ std::vector<Vertex>& Shape::GetWorldSpaceVertices()
 //
 void Shape::CreateVertex(const Vertex& vertex)
 {
-	_shapeData.push_back(vertex);
+	_shapeData.Add(vertex);
+	_clipSpaceData.Add(vertex);
+	_worldSpaceData.Add(vertex);
 
-	_clipSpaceData.resize(_shapeData.size(), Vertex(vertex));
-	_worldSpaceData.resize(_shapeData.size(), Vertex(vertex));
+	_isTransformed = false;
+	_hasBounds = false;
 }
 
 //
@@ -140,13 +161,161 @@ void Shape::CreateVertices(const std::vector<Vertex>& vertices)
 
 void Shape::ClearVertices()
 {
-	_shapeData.clear();
+	_shapeData.Clear();
+	_clipSpaceData.Clear();
+	_worldSpaceData.Clear();
+
+	_isTransformed = false;
+	_hasBounds = false;
+}
+
+//
+// Replaces every vertex at once. The world and clip space buffers start as
+// copies of the model-space one, attributes included, just as if every
+// vertex had been created one by one.
+//
+void Shape::SetVertices(VertexBuffer&& vertices)
+{
+	_shapeData = std::move(vertices);
+	_clipSpaceData = _shapeData;
+	_worldSpaceData = _shapeData;
+
+	_isTransformed = false;
+	_hasBounds = false;
+}
+
+//
+// Replaces the model-space normals of every vertex, which are transformed
+// again the next time the shape is.
+//
+void Shape::SetNormals(const std::vector<Vector3>& normals)
+{
+	_shapeData.GetNormals() = normals;
+
+	_isTransformed = false;
+}
+
+//
+// Model-space vertices, which are transformed again the next time the shape is.
+// The bounds must already contain wherever they are moved to.
+//
+VertexBuffer& Shape::EditVertices()
+{
+	_isTransformed = false;
+
+	return _shapeData;
+}
+
+//
+// Calculates the model-space bounds of the current vertices.
+//
+void Shape::CalculateBounds()
+{
+	_localBounds = BoundingBox::FromVertices(_shapeData);
+	_localSphere = BoundingSphere::FromVertices(_shapeData, _localBounds);
+
+	_hasBounds = true;
+	_areWorldBoundsValid = false;
+}
+
+//
+// Sets the model-space bounds, with a sphere reaching the corners of the box.
+//
+void Shape::SetBounds(const BoundingBox& bounds)
+{
+	_localBounds = bounds;
+	_localSphere = { bounds.GetCentre(), bounds.GetExtents().GetMagnitude() };
+
+	_hasBounds = true;
+	_areWorldBoundsValid = false;
+}
+
+//
+// Sets the model-space bounds, along with a sphere already calculated for them.
+//
+void Shape::SetBounds(const BoundingBox& bounds, const BoundingSphere& sphere)
+{
+	_localBounds = bounds;
+	_localSphere = sphere;
+
+	_hasBounds = true;
+	_areWorldBoundsValid = false;
+}
+
+//
+// Whether the bounds of this shape have been calculated.
+//
+const bool& Shape::HasBounds() const
+{
+	return _hasBounds;
+}
+
+//
+// The model-space bounding box.
+//
+const BoundingBox& Shape::GetLocalBounds() const
+{
+	return _localBounds;
+}
+
+//
+// The model-space bounding sphere.
+//
+const BoundingSphere& Shape::GetLocalSphere() const
+{
+	return _localSphere;
+}
+
+//
+// The world-space bounding box.
+//
+const BoundingBox& Shape::GetWorldBounds() const
+{
+	if (!_areWorldBoundsValid || _boundsVersion != GetTransformVersion())
+	{
+		_worldBounds = _localBounds.Transform(GetTransform());
+		_worldSphere = _localSphere.Transform(GetTransform());
+
+		_boundsVersion = GetTransformVersion();
+		_areWorldBoundsValid = true;
+	}
+
+	return _worldBounds;
+}
+
+//
+// The world-space bounding sphere.
+//
+const BoundingSphere& Shape::GetWorldSphere() const
+{
+	// Both bounds are kept up to date together.
+	GetWorldBounds();
+
+	return _worldSphere;
+}
+
+//
+// Whether any part of the shape can be seen from the main camera. The cheap
+// sphere test goes first, the box only refines its answer.
+//
+const bool Shape::IsInView() const
+{
+	const Camera* const mainCamera = Camera::GetMainCamera();
+
+	if (!_hasBounds || !mainCamera)
+	{
+		return true;
+	}
+
+	const Frustum& frustum = mainCamera->GetConstants().frustum;
+
+	return frustum.Intersects(GetWorldSphere()) && frustum.Intersects(GetWorldBounds());
 }
 
 //
 // Returns a read-only reference to the existing vertices.
 //
-const std::vector<Vertex>& Shape::GetVertices() const
+const VertexBuffer& Shape::GetVertices() const
 {
 	return _shapeData;
 }
@@ -156,7 +325,7 @@ const std::vector<Vertex>& Shape::GetVertices() const
 //
 const size_t Shape::GetVerticesCount() const
 {
-	return _shapeData.size();
+	return _shapeData.GetCount();
 }
 
 //
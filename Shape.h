@@ -2,8 +2,10 @@
 #include <vector>
 #include "Vector.h"
 #include "Vertex.h"
+#include "VertexBuffer.h"
 #include "Matrix.h"
 #include "Transformable.h"
+#include "Bounds.h"
 #include "Colour.h"
 #include <Windows.h>
 #include <stack>
@@ -35,12 +37,28 @@ public:
 	//
 	// Model-space vertices (read-only).
 	//
-	const std::vector<Vertex>& GetVertices() const;
+	const VertexBuffer& GetVertices() const;
 	const size_t GetVerticesCount() const;
 
 	const Colour GetColour() const;
 	void SetColour(const Colour& colour);
 
+	//
+	// Bounds of the model-space vertices, and of the shape once placed in the
+	// world. World bounds are only recalculated after the shape is transformed.
+	//
+	const bool& HasBounds() const;
+	const BoundingBox& GetLocalBounds() const;
+	const BoundingSphere& GetLocalSphere() const;
+	const BoundingBox& GetWorldBounds() const;
+	const BoundingSphere& GetWorldSphere() const;
+
+	//
+	// Whether any part of the shape can be seen from the main camera. Shapes
+	// without calculated bounds are always considered in view.
+	//
+	const bool IsInView() const;
+
 	//
 	// Full equality operator.
 	//
@@ -52,38 +70,90 @@ protected:
 	void ClearVertices();
 
 	//
-	// World-space vertices (read-only).
+	// Replaces every vertex, taking over the given buffer.
 	//
-	void CalculateTransformations();
+	void SetVertices(VertexBuffer&& vertices);
 
 	//
-	// Transformations
+	// Replaces the model-space normals of every vertex.
 	//
-	const Matrix GetMVP(const char& type) const;
-	const Matrix GetP2C() const;
+	void SetNormals(const std::vector<Vector3>& normals);
+
+	//
+	// Model-space vertices, for shapes which move their own. They are transformed
+	// again the next time the shape is, but the bounds are kept as they are.
+	//
+	VertexBuffer& EditVertices();
+
+	//
+	// Calculates the model-space bounds of the current vertices.
+	//
+	void CalculateBounds();
+
+	//
+	// Sets the model-space bounds, for shapes whose vertices move within them.
+	//
+	void SetBounds(const BoundingBox& bounds);
+	void SetBounds(const BoundingBox& bounds, const BoundingSphere& sphere);
 
 	//
-	// Final application of all necessary transformations.
+	// Transforms the vertices (and their normals) into world and clip space.
+	// Returns whether anything had to be recalculated.
 	//
-	const Vertex ObjectToClipSpace(const Matrix& mvp, const Matrix& p2c, const Vertex& vertex);
+	const bool CalculateTransformations();
+
+	//
+	// The matrix normals were last transformed into world space by.
+	//
+	const Matrix& GetNormalMatrix() const;
+
+	//
+	// Transformations
+	//
+	const Matrix GetMVP(const char& type) const;
+	const Matrix GetP2C() const;
 
 	//
 	// The world-space vertices without any projection/clip space transformation applied to them.
 	//
-	const std::vector<Vertex>& GetClipSpaceVertices() const;
-	const std::vector<Vertex>& GetWorldSpaceVertices() const;
+	const VertexBuffer& GetClipSpaceVertices() const;
+	const VertexBuffer& GetWorldSpaceVertices() const;
 
 	//
 	// Non-const versions of vertices accessors.
 	//
-	std::vector<Vertex>& GetClipSpaceVertices();
-	std::vector<Vertex>& GetWorldSpaceVertices();
+	VertexBuffer& GetClipSpaceVertices();
+	VertexBuffer& GetWorldSpaceVertices();
 
 private:
 	COLORREF _shapeColour; // The colour of the shape.
 
-	std::vector<Vertex> _shapeData;			// Where the model-space vertices will be stored.
-	std::vector<Vertex> _clipSpaceData;		// Where the clip-space vertices will be stored and updated.
-	std::vector<Vertex> _worldSpaceData;	// WHere the world-space vertices will be stored and updated.
+	VertexBuffer _shapeData;		// Where the model-space vertices will be stored.
+	VertexBuffer _clipSpaceData;	// Where the clip-space vertices will be stored and updated.
+	VertexBuffer _worldSpaceData;	// WHere the world-space vertices will be stored and updated.
+
+	//
+	// Matrices the vertices were last transformed by, along with the versions
+	// of the shape and camera transformations they were built from.
+	//
+	Matrix _modelView;
+	Matrix _modelViewClip;
+	Matrix _normalMatrix;
+	unsigned int _transformVersion = 0;
+	unsigned int _cameraVersion = 0;
+	bool _isTransformed = false;
+
+	//
+	// Model-space bounds, along with their world-space counterparts and the
+	// version of the transformation those were calculated for.
+	//
+	BoundingBox _localBounds;
+	BoundingSphere _localSphere;
+	bool _hasBounds = false;
+
+	mutable BoundingBox _worldBounds;
+	mutable BoundingSphere _worldSphere;
+	mutable unsigned int _boundsVersion = 0;
+	mutable bool _areWorldBoundsValid = false;
 };
 
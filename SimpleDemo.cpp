@@ -14,6 +14,8 @@ void SimpleDemo::OnInit()
 	_pedistal->SetColour(Colour::White);
 	_pedistal->Mode(Mesh::DrawMode::DRAW_FRAGMENT);
 	_pedistal->Shade(Mesh::ShadeMode::SHADE_PHONG);
+	_pedistal->DepthSort(true);
+	_pedistal->Bin(true);
 	_pedistal->SetPosition({ 0, -43.f, 0 });
 
 	_figurine = CreateShape<Mesh>();
@@ -21,6 +23,9 @@ void SimpleDemo::OnInit()
 	_figurine->SetColour(Colour::White);
 	_figurine->Mode(Mesh::DrawMode::DRAW_FRAGMENT);
 	_figurine->Shade(Mesh::ShadeMode::SHADE_PHONG);
+	_figurine->DepthSort(true);
+	_figurine->Bin(true);
+	_figurine->PlayAnimation("stand", 9.f);
 
 	// Create light
 	_directional = Environment::GetActive().CreateLight<DirectionalLight>().get();
@@ -50,6 +55,7 @@ void SimpleDemo::OnTick(const float& deltaTime)
 	// A nice spinning animation!
 	_figurine->Rotate(angle);
 	_pedistal->Rotate(-angle);
+	_figurine->Animate(deltaTime);
 
 	// Move the camera, hurray!
 	Vector3 cameraMovement{ 0, 0, 0 };
@@ -1,4 +1,5 @@
 #include "SpotLight.h"
+#include <cfloat>
 #define PI 3.14159265359f
 
 //
@@ -11,7 +12,7 @@ SpotLight::SpotLight() : Light(), _attenuation{ 0.01f }, _innerAngle{ 0.5f }, _o
 // Full constructor.
 //
 SpotLight::SpotLight(const Vector3& position, const Vector3& direction, const float& atten, const float& inner, const float& outer)
-	: _position{position}, _direction{direction}, _attenuation{atten}, _innerAngle{inner}, _outerAngle{outer}
+	: _position{position}, _direction{Vector3::NormaliseVector(direction)}, _attenuation{atten}, _innerAngle{inner}, _outerAngle{outer}
 { }
 
 //
@@ -42,6 +43,17 @@ Colour SpotLight::CalculateContribution(const Vertex& position, const Vector3& n
 	return GetIntensity() * finalIntensity * spotlightValue;
 }
 
+//
+// The sphere around the light, up to where its attenuation brings it below
+// the cutoff.
+//
+const bool SpotLight::GetBounds(BoundingSphere& bounds) const
+{
+	bounds = { _position, GetRange(_attenuation) };
+
+	return bounds.radius < FLT_MAX;
+}
+
 //
 // The position of this spotlight.
 //
@@ -140,3 +152,11 @@ const float SpotLight::Smoothstep(const float a, const float b, const float x)
 	float t = (x - a) / (b - a);
 	return (3.f - 2.f * t) * (t * t);
 }
+
+//
+// Adds the light to the spot light arrays of a packed light buffer.
+//
+void SpotLight::Pack(LightBuffer& buffer)
+{
+	buffer.AddSpot(GetIntensity(), _position, _direction, _attenuation, _innerAngle, _outerAngle);
+}
@@ -16,6 +16,17 @@ public:
 	//
 	Colour CalculateContribution(const Vertex& position, const Vector3& normal, const Colour& ambient, const float& roughness, const float& specular) override;
 
+	//
+	// The sphere around the light, up to where its attenuation brings it below
+	// the cutoff.
+	//
+	const bool GetBounds(BoundingSphere& bounds) const override;
+
+	//
+	// Adds the light to the spot light arrays of a packed light buffer.
+	//
+	void Pack(LightBuffer& buffer) override;
+
 	//
 	// Light position
 	//
@@ -21,30 +21,31 @@ void Square::CreateModel(const Vector3& position)
 //
 void Square::Draw(HDC hdc)
 {
-	std::vector<Vertex> shape = GetVertices();
+	const VertexBuffer& shape = GetVertices();
+	const size_t count = shape.GetCount();
 
 	// Ensure the shape exists.
-	if (shape.size() == 0)
+	if (count == 0)
 	{
 		return;
 	}
 
+	const float* x = shape.GetX();
+	const float* y = shape.GetY();
+
 	HPEN pen = CreatePen(PS_SOLID, 1, GetColour().AsColor());
 	HPEN old = static_cast<HPEN>(SelectObject(hdc, pen));
 
-	// Iterator to vertices
-	std::vector<Vertex>::const_iterator it = shape.begin();
-	MoveToEx(hdc, static_cast<int>(it->GetX()), static_cast<int>(it->GetY()), NULL);
+	MoveToEx(hdc, static_cast<int>(x[0]), static_cast<int>(y[0]), NULL);
 
 	// Draw lines to all vertices.
-	while (++it != shape.end())
+	for (size_t i = 1; i < count; ++i)
 	{
-		LineTo(hdc, static_cast<int>(it->GetX()), static_cast<int>(it->GetY()));
+		LineTo(hdc, static_cast<int>(x[i]), static_cast<int>(y[i]));
 	}
 
 	// Draw last connection...
-	it = shape.begin();
-	LineTo(hdc, static_cast<int>(it->GetX()), static_cast<int>(it->GetY()));
+	LineTo(hdc, static_cast<int>(x[0]), static_cast<int>(y[0]));
 
 	// Restore old pen, free new pen
 	SelectObject(hdc, old);
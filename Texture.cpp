@@ -6,6 +6,9 @@ Texture::Texture()
 	_height = 0;
 	_paletteIndices = nullptr;
 	_palette = nullptr;
+	_texels = nullptr;
+	_isPowerOfTwo = false;
+	_levelCount = 0;
 }
 
 Texture::~Texture()
@@ -20,12 +23,19 @@ Texture::~Texture()
 		delete[] _palette;
 		_palette = nullptr;
 	}
+	if (_texels != nullptr)
+	{
+		::operator delete[](_texels, TEXEL_ALIGNMENT);
+		_texels = nullptr;
+	}
 }
 
 void Texture::SetTextureSize(size_t width, size_t height)
 {
 	_width = width;
 	_height = height;
+	_levelCount = GetLevels(_width, _height, _levels);
+	_isPowerOfTwo = _width > 0 && _height > 0 && (_width & (_width - 1)) == 0 && (_height & (_height - 1)) == 0;
 	if (_paletteIndices != nullptr)
 	{
 		delete[] _paletteIndices;
@@ -36,6 +46,11 @@ void Texture::SetTextureSize(size_t width, size_t height)
 		delete[] _palette;
 	}
 	_palette = new COLORREF[256];
+	if (_texels != nullptr)
+	{
+		::operator delete[](_texels, TEXEL_ALIGNMENT);
+	}
+	_texels = new (TEXEL_ALIGNMENT) UINT32[GetTexelCount(_width, _height)]();
 }
 
 COLORREF Texture::GetTextureValue(int u, int v) const
@@ -74,6 +89,26 @@ COLORREF * Texture::GetPalette()
 	return _palette;
 }
 
+const BYTE * Texture::GetPaletteIndices() const
+{
+	return _paletteIndices;
+}
+
+const COLORREF * Texture::GetPalette() const
+{
+	return _palette;
+}
+
+UINT32 * Texture::GetTexels()
+{
+	return _texels;
+}
+
+const UINT32 * Texture::GetTexels() const
+{
+	return _texels;
+}
+
 size_t Texture::GetWidth() const
 {
 	return _width;
@@ -83,3 +118,96 @@ size_t Texture::GetHeight() const
 {
 	return _height;
 }
+
+bool Texture::IsPowerOfTwo() const
+{
+	return _isPowerOfTwo;
+}
+
+int Texture::GetLevelCount() const
+{
+	return _levelCount;
+}
+
+size_t Texture::GetTexelCount(size_t width, size_t height)
+{
+	MipLevel levels[MAX_LEVELS];
+	const int levelCount = GetLevels(width, height, levels);
+
+	if (levelCount == 0)
+	{
+		return 0;
+	}
+
+	const MipLevel& last = levels[levelCount - 1];
+
+	return last.offset + last.tilesPerRow * ((last.height + TILE_MASK) >> TILE_SHIFT) * TILE_SIZE * TILE_SIZE;
+}
+
+// Levels halve in size, rounding down, until both sides are a single texel.
+int Texture::GetLevels(size_t width, size_t height, MipLevel (&levels)[MAX_LEVELS])
+{
+	if (width == 0 || height == 0)
+	{
+		return 0;
+	}
+
+	size_t offset = 0;
+	int count = 0;
+
+	while (count < MAX_LEVELS)
+	{
+		MipLevel& level = levels[count++];
+
+		level.width = static_cast<int>(width);
+		level.height = static_cast<int>(height);
+		level.tilesPerRow = (width + TILE_MASK) >> TILE_SHIFT;
+		level.offset = offset;
+
+		offset += level.tilesPerRow * ((height + TILE_MASK) >> TILE_SHIFT) * TILE_SIZE * TILE_SIZE;
+
+		if (width == 1 && height == 1)
+		{
+			break;
+		}
+
+		width = max(width / 2, static_cast<size_t>(1));
+		height = max(height / 2, static_cast<size_t>(1));
+	}
+
+	return count;
+}
+
+// Every texel is the average of the four below it, or of those there are on
+// the odd edges of textures which are not a power of two.
+void Texture::GenerateMipmaps()
+{
+	for (int level = 1; level < _levelCount; ++level)
+	{
+		const MipLevel& source = _levels[level - 1];
+		const MipLevel& target = _levels[level];
+
+		for (int y = 0; y < target.height; ++y)
+		{
+			const int top = y * 2;
+			const int bottom = min(top + 1, source.height - 1);
+
+			for (int x = 0; x < target.width; ++x)
+			{
+				const int left = x * 2;
+				const int right = min(left + 1, source.width - 1);
+
+				const UINT32 a = _texels[GetTexelOffset(left, top, level - 1)];
+				const UINT32 b = _texels[GetTexelOffset(right, top, level - 1)];
+				const UINT32 c = _texels[GetTexelOffset(left, bottom, level - 1)];
+				const UINT32 d = _texels[GetTexelOffset(right, bottom, level - 1)];
+
+				// Channels are summed in place, there is room above each for the carry.
+				const UINT32 redBlue = ((a & 0x00FF00FF) + (b & 0x00FF00FF) + (c & 0x00FF00FF) + (d & 0x00FF00FF) + 0x00020002) >> 2;
+				const UINT32 green = ((a & 0x0000FF00) + (b & 0x0000FF00) + (c & 0x0000FF00) + (d & 0x0000FF00) + 0x00000200) >> 2;
+
+				_texels[GetTexelOffset(x, y, level)] = (redBlue & 0x00FF00FF) | (green & 0x0000FF00);
+			}
+		}
+	}
+}
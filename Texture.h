@@ -1,5 +1,30 @@
 #pragma once
 #include "windows.h"
+#include <cmath>
+#include <new>
+
+//
+// How coordinates outside of a texture are mapped onto it when sampling.
+//
+enum class TextureAddress
+{
+	ADDRESS_CLAMP,		// Coordinates past an edge take the texel on that edge.
+	ADDRESS_WRAP		// Coordinates repeat the texture, which must be a power of two in size.
+};
+
+//
+// How the texels of a span are filtered. Every mode but the first samples the
+// mip level whose texels are closest in size to the span's footprint, so that
+// distant surfaces read from small levels rather than skipping across the
+// full size texture.
+//
+enum class TextureFilter
+{
+	FILTER_NEAREST,		// The nearest texel of the full size texture, whatever the footprint.
+	FILTER_MIPMAP,		// The nearest texel of the closest mip level.
+	FILTER_BILINEAR,	// The four nearest texels of the closest mip level, blended.
+	FILTER_TRILINEAR	// Bilinear samples of the two mip levels around the footprint, blended.
+};
 
 /*
 *
@@ -25,14 +50,201 @@ public:
 
 	void		SetTextureSize(size_t width, size_t height);
 	COLORREF	GetTextureValue(int u, int v) const;
+
+	// Samples the texel at (u, v) of the given mip level, in that level's
+	// texels, as a pixel (0x00RRGGBB), or white if no texture was loaded.
+	template<TextureAddress Address>
+	UINT32		Sample(int u, int v, int level = 0) const;
+
+	// Samples the texels at the UVs of a span (in texels of the full size
+	// texture), filtered for a span whose UVs step footprint texels from one
+	// pixel to the next.
+	template<TextureAddress Address>
+	void		SampleSpan(const float* u, const float* v, const int& count, const float& footprint, const TextureFilter& filter, UINT32* texels) const;
+
+	// Builds every mip level below the full size one, from the full size texels.
+	void		GenerateMipmaps();
+
+	// Position of the texel at (u, v) of the given mip level in the tiled texels.
+	size_t		GetTexelOffset(int u, int v, int level = 0) const;
 	BYTE *		GetPaletteIndices();
 	COLORREF *	GetPalette();
+	const BYTE *		GetPaletteIndices() const;
+	const COLORREF *	GetPalette() const;
+
+	// Every palette index expanded into its colour, as a pixel (0x00RRGGBB).
+	// Texels are stored in tiles rather than rows, see GetTexelOffset, with
+	// each mip level following the one twice its size.
+	UINT32 *			GetTexels();
+	const UINT32 *		GetTexels() const;
 	size_t		GetWidth() const;
 	size_t		GetHeight() const;
+	int			GetLevelCount() const;
+	bool		IsPowerOfTwo() const;
+
+	// Amount of texels stored for a texture of the given size, including
+	// every mip level and those padding their edge tiles.
+	static size_t GetTexelCount(size_t width, size_t height);
+
+	// Texels are stored in square tiles of TILE_SIZE, each filling a single
+	// cache line, so that the texels around a sample are close together
+	// whichever direction a span walks across the texture.
+	static constexpr int TILE_SHIFT = 2;
+	static constexpr int TILE_SIZE = 1 << TILE_SHIFT;
+	static constexpr int TILE_MASK = TILE_SIZE - 1;
+
+	// Enough mip levels for textures up to 32768 texels across.
+	static constexpr int MAX_LEVELS = 16;
 
 private:
+	// Texels are allocated on cache line boundaries, so that tiles never straddle two lines.
+	static constexpr std::align_val_t TEXEL_ALIGNMENT{ 64 };
+
+	struct MipLevel
+	{
+		int width;
+		int height;
+		size_t tilesPerRow;
+		size_t offset;		// Of the level's first texel, from the first texel of the texture.
+	};
+
+	// Builds the size and position of every level of a texture of the given size.
+	static int GetLevels(size_t width, size_t height, MipLevel (&levels)[MAX_LEVELS]);
+
+	template<TextureAddress Address>
+	UINT32		SampleBilinear(const float& u, const float& v, const int& level) const;
+
+	// Blends two pixels, weight being out of 256 towards the second.
+	static UINT32 Blend(const UINT32& a, const UINT32& b, const int& weight);
+
 	BYTE	 * _paletteIndices;
 	COLORREF * _palette;
+	UINT32	 * _texels;
 	size_t	 _width;
 	size_t	 _height;
-};
\ No newline at end of file
+	bool	 _isPowerOfTwo;
+
+	MipLevel _levels[MAX_LEVELS];
+	int		 _levelCount;
+};
+
+inline size_t Texture::GetTexelOffset(int u, int v, int level) const
+{
+	const MipLevel& mip = _levels[level];
+	const size_t tile = static_cast<size_t>(v >> TILE_SHIFT) * mip.tilesPerRow + static_cast<size_t>(u >> TILE_SHIFT);
+
+	return mip.offset + ((tile << (TILE_SHIFT * 2)) | ((v & TILE_MASK) << TILE_SHIFT) | (u & TILE_MASK));
+}
+
+inline UINT32 Texture::Blend(const UINT32& a, const UINT32& b, const int& weight)
+{
+	// Red and blue are blended together, with a byte of room above each.
+	const UINT32 redBlue = ((a & 0x00FF00FF) * (256 - weight) + (b & 0x00FF00FF) * weight) >> 8;
+	const UINT32 green = ((a & 0x0000FF00) * (256 - weight) + (b & 0x0000FF00) * weight) >> 8;
+
+	return (redBlue & 0x00FF00FF) | (green & 0x0000FF00);
+}
+
+template<TextureAddress Address>
+inline UINT32 Texture::Sample(int u, int v, int level) const
+{
+	if (!_texels)
+	{
+		return 0x00FFFFFF; // Default to white if no texture can be sampled.
+	}
+
+	const MipLevel& mip = _levels[level];
+
+	if constexpr (Address == TextureAddress::ADDRESS_WRAP)
+	{
+		u &= mip.width - 1;
+		v &= mip.height - 1;
+	}
+	else
+	{
+		u = min(max(u, 0), mip.width - 1);
+		v = min(max(v, 0), mip.height - 1);
+	}
+
+	return _texels[GetTexelOffset(u, v, level)];
+}
+
+// Blends the four texels of the level around (u, v), given in texels of the full size texture.
+template<TextureAddress Address>
+inline UINT32 Texture::SampleBilinear(const float& u, const float& v, const int& level) const
+{
+	const float scale = 1.f / static_cast<float>(1 << level);
+
+	// Texel centres are half a texel in.
+	const float x = u * scale - .5f;
+	const float y = v * scale - .5f;
+
+	const float left = std::floor(x);
+	const float top = std::floor(y);
+
+	const int x0 = static_cast<int>(left);
+	const int y0 = static_cast<int>(top);
+	const int blendX = static_cast<int>((x - left) * 256);
+	const int blendY = static_cast<int>((y - top) * 256);
+
+	const UINT32 upper = Blend(Sample<Address>(x0, y0, level), Sample<Address>(x0 + 1, y0, level), blendX);
+	const UINT32 lower = Blend(Sample<Address>(x0, y0 + 1, level), Sample<Address>(x0 + 1, y0 + 1, level), blendX);
+
+	return Blend(upper, lower, blendY);
+}
+
+//
+// The level of detail is picked once for the whole span, as the rasterisers
+// only provide the change in UV along it. Each filter then has its own loop.
+//
+template<TextureAddress Address>
+inline void Texture::SampleSpan(const float* u, const float* v, const int& count, const float& footprint, const TextureFilter& filter, UINT32* texels) const
+{
+	// Levels halve in size, so every doubling of the footprint moves down a level.
+	const float detail = footprint > 1 && _levelCount > 1 ? min(std::log2(footprint), static_cast<float>(_levelCount - 1)) : 0.f;
+
+	switch (filter)
+	{
+	case TextureFilter::FILTER_MIPMAP:
+	{
+		const int level = static_cast<int>(detail + .5f);
+
+		for (int i = 0; i < count; ++i)
+		{
+			texels[i] = Sample<Address>(static_cast<int>(u[i]) >> level, static_cast<int>(v[i]) >> level, level);
+		}
+		break;
+	}
+
+	case TextureFilter::FILTER_BILINEAR:
+	{
+		const int level = static_cast<int>(detail + .5f);
+
+		for (int i = 0; i < count; ++i)
+		{
+			texels[i] = SampleBilinear<Address>(u[i], v[i], level);
+		}
+		break;
+	}
+
+	case TextureFilter::FILTER_TRILINEAR:
+	{
+		const int level = static_cast<int>(detail);
+		const int next = min(level + 1, max(_levelCount - 1, 0));
+		const int blend = static_cast<int>((detail - level) * 256);
+
+		for (int i = 0; i < count; ++i)
+		{
+			texels[i] = Blend(SampleBilinear<Address>(u[i], v[i], level), SampleBilinear<Address>(u[i], v[i], next), blend);
+		}
+		break;
+	}
+
+	default:
+		for (int i = 0; i < count; ++i)
+		{
+			texels[i] = Sample<Address>(static_cast<int>(u[i]), static_cast<int>(v[i]));
+		}
+		break;
+	}
+}
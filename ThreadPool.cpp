@@ -0,0 +1,169 @@
+#include "ThreadPool.h"
+
+//
+// Creates a pool with one thread per hardware core.
+//
+ThreadPool::ThreadPool()
+{
+	Resize(std::thread::hardware_concurrency());
+}
+
+//
+// Joins every worker.
+//
+ThreadPool::~ThreadPool()
+{
+	StopWorkers();
+}
+
+//
+// Changes the amount of threads (including the calling one) that take part
+// in parallel work.
+//
+void ThreadPool::Resize(const unsigned int& threadCount)
+{
+	const unsigned int workerCount = threadCount > 1 ? threadCount - 1 : 0;
+
+	if (workerCount == _workers.size())
+	{
+		return;
+	}
+
+	StopWorkers();
+	StartWorkers(workerCount);
+}
+
+//
+// The amount of threads (including the calling one) that take part in parallel work.
+//
+const unsigned int ThreadPool::GetThreadCount() const
+{
+	return static_cast<unsigned int>(_workers.size()) + 1;
+}
+
+//
+// Runs the task once for every index in [0, count) and blocks until all
+// of them have completed.
+//
+void ThreadPool::ParallelFor(const size_t& count, const Task& task)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	// Not worth waking anybody up.
+	if (count == 1 || _workers.empty())
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			task(i);
+		}
+
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_task = &task;
+		_taskCount = count;
+		_nextTask = 0;
+		_busyWorkers = _workers.size();
+		++_generation;
+	}
+
+	_wakeCondition.notify_all();
+
+	RunTasks();
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	_doneCondition.wait(lock, [this]() { return _busyWorkers == 0; });
+
+	_task = nullptr;
+}
+
+//
+// The pool shared by the whole renderer.
+//
+ThreadPool& ThreadPool::Get()
+{
+	static ThreadPool pool;
+	return pool;
+}
+
+//
+// Spawns the given amount of workers.
+//
+void ThreadPool::StartWorkers(const unsigned int& workerCount)
+{
+	_stopping = false;
+	_workers.reserve(workerCount);
+
+	for (unsigned int i = 0; i < workerCount; ++i)
+	{
+		_workers.emplace_back(&ThreadPool::WorkerLoop, this, _generation);
+	}
+}
+
+//
+// Signals every worker to exit and waits for them.
+//
+void ThreadPool::StopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+
+	_wakeCondition.notify_all();
+
+	for (std::thread& worker : _workers)
+	{
+		worker.join();
+	}
+
+	_workers.clear();
+}
+
+//
+// Waits for work to be handed out and helps finishing it. The generation
+// is that of the last batch of work handed out before the worker was started.
+//
+void ThreadPool::WorkerLoop(size_t generation)
+{
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wakeCondition.wait(lock, [this, &generation]() { return _stopping || _generation != generation; });
+
+			if (_stopping)
+			{
+				return;
+			}
+
+			generation = _generation;
+		}
+
+		RunTasks();
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			--_busyWorkers;
+		}
+
+		_doneCondition.notify_one();
+	}
+}
+
+//
+// Takes tasks from the shared counter until none are left.
+//
+void ThreadPool::RunTasks()
+{
+	for (size_t i = _nextTask++; i < _taskCount; i = _nextTask++)
+	{
+		(*_task)(i);
+	}
+}
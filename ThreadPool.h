@@ -0,0 +1,60 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+//
+// Fixed set of worker threads used to split frame work (such as rasterising
+// screen tiles) across every available core. The calling thread always takes
+// part in the work, so a pool of N threads only spawns N - 1 workers.
+//
+class ThreadPool
+{
+public:
+	using Task = std::function<void(const size_t& index)>;
+
+	ThreadPool();
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	//
+	// Thread management.
+	//
+	void Resize(const unsigned int& threadCount);
+	const unsigned int GetThreadCount() const;
+
+	//
+	// Runs the task once for every index in [0, count) and blocks until all
+	// of them have completed.
+	//
+	void ParallelFor(const size_t& count, const Task& task);
+
+	static ThreadPool& Get();
+
+private:
+	void StartWorkers(const unsigned int& workerCount);
+	void StopWorkers();
+
+	void WorkerLoop(size_t generation);
+	void RunTasks();
+
+private:
+	std::vector<std::thread> _workers;
+
+	std::mutex _mutex;
+	std::condition_variable _wakeCondition;
+	std::condition_variable _doneCondition;
+
+	const Task* _task{ nullptr };
+	size_t _taskCount{ 0 };
+	std::atomic<size_t> _nextTask{ 0 };
+
+	size_t _busyWorkers{ 0 };
+	size_t _generation{ 0 };
+	bool _stopping{ false };
+};
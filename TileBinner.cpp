@@ -0,0 +1,110 @@
+#include "TileBinner.h"
+#include <cmath>
+
+//
+// Empties every tile and resizes the grid to cover the target's clip rectangle.
+//
+void TileBinner::Reset(const FrameBuffer& target)
+{
+	_target = target;
+
+	_tilesX = (target.clipRight + TILE_SIZE - 1) / TILE_SIZE;
+	_tilesY = (target.clipBottom + TILE_SIZE - 1) / TILE_SIZE;
+
+	_tiles.resize(static_cast<size_t>(_tilesX) * _tilesY);
+
+	// Keep the allocations around, the same amount of triangles is likely to come next frame.
+	for (std::vector<const Polygon3D*>& tile : _tiles)
+	{
+		tile.clear();
+	}
+}
+
+//
+// Adds a triangle (given by its screen space vertices) to every tile its
+// bounding rectangle overlaps.
+//
+void TileBinner::Insert(const Polygon3D* polygon, const Vector3& a, const Vector3& b, const Vector3& c)
+{
+	InsertBounds(polygon, min(a.GetX(), min(b.GetX(), c.GetX())), min(a.GetY(), min(b.GetY(), c.GetY())), max(a.GetX(), max(b.GetX(), c.GetX())), max(a.GetY(), max(b.GetY(), c.GetY())));
+}
+
+//
+// Adds a clipped triangle to every tile the bounding rectangle of what is
+// left of it overlaps.
+//
+void TileBinner::Insert(const Polygon3D* polygon, const ClippedPolygon& clipped)
+{
+	float left = clipped.clipSpace[0].GetX();
+	float top = clipped.clipSpace[0].GetY();
+	float right = left;
+	float bottom = top;
+
+	for (int i = 1; i < clipped.count; ++i)
+	{
+		left = min(left, clipped.clipSpace[i].GetX());
+		top = min(top, clipped.clipSpace[i].GetY());
+		right = max(right, clipped.clipSpace[i].GetX());
+		bottom = max(bottom, clipped.clipSpace[i].GetY());
+	}
+
+	InsertBounds(polygon, left, top, right, bottom);
+}
+
+//
+// Adds a triangle to every tile the given screen bounds overlap.
+//
+void TileBinner::InsertBounds(const Polygon3D* polygon, const float& left, const float& top, const float& right, const float& bottom)
+{
+	// A pixel is covered when its centre lies on the triangle, so the covered
+	// columns and rows never go past the floor of the bounds.
+	const int minX = static_cast<int>(std::floor(left));
+	const int maxX = static_cast<int>(std::floor(right));
+	const int minY = static_cast<int>(std::floor(top));
+	const int maxY = static_cast<int>(std::floor(bottom));
+
+	if (maxX < _target.clipLeft || minX >= _target.clipRight || maxY < _target.clipTop || minY >= _target.clipBottom)
+	{
+		return;
+	}
+
+	const int sourceTileX = max(minX, _target.clipLeft) / TILE_SIZE;
+	const int targetTileX = min(maxX, _target.clipRight - 1) / TILE_SIZE;
+	const int sourceTileY = max(minY, _target.clipTop) / TILE_SIZE;
+	const int targetTileY = min(maxY, _target.clipBottom - 1) / TILE_SIZE;
+
+	for (int y = sourceTileY; y <= targetTileY; ++y)
+	{
+		for (int x = sourceTileX; x <= targetTileX; ++x)
+		{
+			_tiles[static_cast<size_t>(y) * _tilesX + x].push_back(polygon);
+		}
+	}
+}
+
+//
+// The amount of tiles in the grid.
+//
+const size_t TileBinner::GetTileCount() const
+{
+	return _tiles.size();
+}
+
+//
+// The triangles overlapping a tile, in insertion order.
+//
+const std::vector<const Polygon3D*>& TileBinner::GetTile(const size_t& index) const
+{
+	return _tiles[index];
+}
+
+//
+// A view over the target which only allows writing within a tile.
+//
+const FrameBuffer TileBinner::GetTileRegion(const size_t& index) const
+{
+	const int left = static_cast<int>(index % _tilesX) * TILE_SIZE;
+	const int top = static_cast<int>(index / _tilesX) * TILE_SIZE;
+
+	return _target.GetRegion(left, top, left + TILE_SIZE, top + TILE_SIZE);
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <vector>
+#include "FrameBuffer.h"
+#include "Polygon3D.h"
+#include "Clipper.h"
+
+//
+// Size (in pixels) of the side of a screen tile.
+//
+constexpr int TILE_SIZE = 64;
+
+//
+// Splits the screen into square tiles and sorts triangles into every tile
+// their screen bounds overlap. Each tile keeps the order in which triangles
+// were inserted, so tiles can be rasterised independently (and in parallel)
+// while producing the same image as drawing every triangle in turn.
+//
+class TileBinner
+{
+public:
+	void Reset(const FrameBuffer& target);
+	void Insert(const Polygon3D* polygon, const Vector3& a, const Vector3& b, const Vector3& c);
+	void Insert(const Polygon3D* polygon, const ClippedPolygon& clipped);
+
+	const size_t GetTileCount() const;
+	const std::vector<const Polygon3D*>& GetTile(const size_t& index) const;
+	const FrameBuffer GetTileRegion(const size_t& index) const;
+
+private:
+	void InsertBounds(const Polygon3D* polygon, const float& left, const float& top, const float& right, const float& bottom);
+
+private:
+	FrameBuffer _target;
+
+	int _tilesX{ 0 };
+	int _tilesY{ 0 };
+
+	std::vector<std::vector<const Polygon3D*>> _tiles;
+};
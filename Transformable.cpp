@@ -11,9 +11,32 @@ Transformable::Transformable() : _position(Matrix::IdentityMatrix()),
 //
 // Returns the combined transformation matrix.
 //
-const Matrix Transformable::GetTransform() const
+const Matrix& Transformable::GetTransform() const
 {
-	return _position * _rotation * _scale;
+	if (_isDirty)
+	{
+		_transform = _position * _rotation * _scale;
+		_isDirty = false;
+	}
+
+	return _transform;
+}
+
+//
+// Changes every time the transformation does.
+//
+const unsigned int& Transformable::GetTransformVersion() const
+{
+	return _version;
+}
+
+//
+// Flags the combined transformation matrix as out of date.
+//
+void Transformable::MarkDirty()
+{
+	_isDirty = true;
+	++_version;
 }
 
 //
@@ -22,6 +45,7 @@ const Matrix Transformable::GetTransform() const
 void Transformable::SetPosition(const Vector3& position)
 {
 	_position = Matrix::TranslationMatrix(position.GetX(), position.GetY(), position.GetZ());
+	MarkDirty();
 }
 
 //
@@ -30,6 +54,7 @@ void Transformable::SetPosition(const Vector3& position)
 void Transformable::SetRotation(const Vector3& rotation)
 {
 	_rotation = Matrix::RotationMatrix(rotation.GetX(), rotation.GetY(), rotation.GetZ());
+	MarkDirty();
 }
 
 //
@@ -38,6 +63,7 @@ void Transformable::SetRotation(const Vector3& rotation)
 void Transformable::SetScale(const Vector3& scale)
 {
 	_scale = Matrix::ScaleMatrix(scale.GetX(), scale.GetY(), scale.GetZ());
+	MarkDirty();
 }
 
 //
@@ -47,6 +73,7 @@ void Transformable::Translate(const Vector3& amount)
 {
 	Matrix translation = _position * Matrix::TranslationMatrix(amount.GetX(), amount.GetY(), amount.GetZ());
 	_position = translation;
+	MarkDirty();
 }
 
 //
@@ -56,6 +83,7 @@ void Transformable::Rotate(const Vector3& amount)
 {
 	Matrix rotation = _rotation * Matrix::RotationMatrix(amount.GetX(), amount.GetY(), amount.GetZ());
 	_rotation = rotation;
+	MarkDirty();
 }
 
 //
@@ -65,4 +93,5 @@ void Transformable::Scale(const Vector3& amount)
 {
 	Matrix scale = _scale * Matrix::ScaleMatrix(amount.GetX(), amount.GetY(), amount.GetZ());
 	_scale = scale;
+	MarkDirty();
 }
\ No newline at end of file
@@ -15,9 +15,14 @@ public:
 	//
 	// Gets a TRS (Translation Rotation Scale) matrix from
 	// the shape's current location, rotation, and scale
-	// matrices.
+	// matrices. Only recombined after any of them changed.
 	//
-	virtual const Matrix GetTransform() const;
+	virtual const Matrix& GetTransform() const;
+
+	//
+	// Changes every time the transformation does.
+	//
+	const unsigned int& GetTransformVersion() const;
 
 	//
 	// Transformation overrides, these will overwrite
@@ -36,6 +41,9 @@ public:
 	virtual void Rotate(const Vector3& amount);
 	virtual void Scale(const Vector3& amount);
 
+private:
+	void MarkDirty();
+
 private:
 	//
 	// Transformation matrices
@@ -43,5 +51,12 @@ private:
 	Matrix _position;
 	Matrix _rotation;
 	Matrix _scale;
+
+	//
+	// Combined transformation, cached until any of the matrices above changes.
+	//
+	mutable Matrix _transform;
+	mutable bool _isDirty = true;
+	unsigned int _version = 0;
 };
 
@@ -7,8 +7,10 @@
 // Rasterises a triangle using the standard flat rasterisation
 // technique.
 //
-void TriangleRasteriser::DrawFlat(const HDC& hdc, const PolygonData& clipSpace)
+void TriangleRasteriser::DrawFlat(const FrameBuffer& target, const PolygonData& clipSpace, const Colour& colour)
 {
+	const UINT32 pixel = FrameBuffer::Pack(colour.GetRed(), colour.GetGreen(), colour.GetBlue());
+
 	// Make copies of the vertices (not references) as we'll need to sort them.
 	Vertex a = clipSpace.a;
 	Vertex b = clipSpace.b;
@@ -29,22 +31,22 @@ void TriangleRasteriser::DrawFlat(const HDC& hdc, const PolygonData& clipSpace)
 	 * or that of a top-flat triangle. */
 	if (b.GetY() == c.GetY())
 	{
-		TopFlatShaded(hdc, data);
+		TopFlatShaded(target, data, pixel);
 	}
 	else if (a.GetY() == b.GetY())
 	{
-		BottomFlatShaded(hdc, data);
+		BottomFlatShaded(target, data, pixel);
 	}
 	else
 	{
 		// general case - split the triangle in a topflat and bottom-flat one
-		Vertex tempVertex(a.GetX() + ((b.GetY() - a.GetY()) / (c.GetY() - a.GetY())) * (c.GetX() - a.GetX()), b.GetY(), 0);
+		Vertex tempVertex(GetSplitVertex(a, b, c));
 
 		PolygonData topTriangle{ a, b, tempVertex };
 		PolygonData bottomTriangle{ b, tempVertex, c };
 
-		TopFlatShaded(hdc, topTriangle);
-		BottomFlatShaded(hdc, bottomTriangle);
+		TopFlatShaded(target, topTriangle, pixel);
+		BottomFlatShaded(target, bottomTriangle, pixel);
 	}
 }
 
@@ -52,7 +54,7 @@ void TriangleRasteriser::DrawFlat(const HDC& hdc, const PolygonData& clipSpace)
 // Rasterises a triangle using the standard solid rasterisation
 // technique, shading on a vertex-by-vertex basis.
 //
-void TriangleRasteriser::DrawSmooth(const HDC& hdc, const PolygonData& clipSpace)
+void TriangleRasteriser::DrawSmooth(const FrameBuffer& target, const PolygonData& clipSpace)
 {
 	// Make copies of the vertices (not references) as we'll need to sort them.
 	Vertex a = clipSpace.a;
@@ -74,11 +76,11 @@ void TriangleRasteriser::DrawSmooth(const HDC& hdc, const PolygonData& clipSpace
 	 * or that of a top-flat triangle. */
 	if (b.GetY() == c.GetY())
 	{
-		TopSmoothShaded(hdc, data);
+		TopSmoothShaded(target, data);
 	}
 	else if (a.GetY() == b.GetY())
 	{
-		BottomSmoothShaded(hdc, data);
+		BottomSmoothShaded(target, data);
 	}
 	else
 	{
@@ -88,8 +90,8 @@ void TriangleRasteriser::DrawSmooth(const HDC& hdc, const PolygonData& clipSpace
 		PolygonData topTriangle{ a, b, tempVertex };
 		PolygonData bottomTriangle{ b, tempVertex, c };
 
-		TopSmoothShaded(hdc, topTriangle);
-		BottomSmoothShaded(hdc, bottomTriangle);
+		TopSmoothShaded(target, topTriangle);
+		BottomSmoothShaded(target, bottomTriangle);
 	}
 }
 
@@ -97,7 +99,7 @@ void TriangleRasteriser::DrawSmooth(const HDC& hdc, const PolygonData& clipSpace
 // Rasterises a triangle using the standard solid rasterisation
 // technique, shading on a fragment-by-fragment basis.
 //
-void TriangleRasteriser::DrawPhong(const HDC& hdc, const PolygonData& clipSpace, const PolygonData& worldSpace, const FragmentFunction& frag)
+void TriangleRasteriser::DrawPhong(const FrameBuffer& target, const PolygonData& clipSpace, const PolygonData& worldSpace, const FragmentFunction& frag)
 {
 	// Make copies of the vertices (not references) as we'll need to sort them.
 	Vertex c0(clipSpace.a);
@@ -123,11 +125,11 @@ void TriangleRasteriser::DrawPhong(const HDC& hdc, const PolygonData& clipSpace,
 	 * or that of a top-flat triangle. */
 	if (clipData.b.GetY() == clipData.c.GetY())
 	{
-		TopPhongShaded(hdc, clipData, worldData, frag);
+		TopPhongShaded(target, clipData, worldData, frag);
 	}
 	else if (clipData.a.GetY() == clipData.b.GetY())
 	{
-		BottomPhongShaded(hdc, clipData, worldData, frag);
+		BottomPhongShaded(target, clipData, worldData, frag);
 	}
 	else
 	{
@@ -141,8 +143,8 @@ void TriangleRasteriser::DrawPhong(const HDC& hdc, const PolygonData& clipSpace,
 		const PolygonData topWorldTriangle{ worldData.a, worldData.b, worldTemp };
 		const PolygonData bottomWorldTriangle{ worldData.b, worldTemp, worldData.c };
 
-		TopPhongShaded(hdc, topClipTriangle, topWorldTriangle, frag);
-		BottomPhongShaded(hdc, bottomClipTriangle, bottomWorldTriangle, frag);
+		TopPhongShaded(target, topClipTriangle, topWorldTriangle, frag);
+		BottomPhongShaded(target, bottomClipTriangle, bottomWorldTriangle, frag);
 	}
 }
 
@@ -151,7 +153,7 @@ void TriangleRasteriser::DrawPhong(const HDC& hdc, const PolygonData& clipSpace,
 // Precondition is that v2 and v3 perform the flat side and 
 // that v1.y < v2.y, v3.y.
 //
-void TriangleRasteriser::TopFlatShaded(const HDC& hdc, const PolygonData& clipSpace)
+void TriangleRasteriser::TopFlatShaded(const FrameBuffer& target, const PolygonData& clipSpace, const UINT32& pixel)
 {
 	const Vertex& v0 = clipSpace.a;
 	const Vertex& v1 = clipSpace.b;
@@ -160,23 +162,23 @@ void TriangleRasteriser::TopFlatShaded(const HDC& hdc, const PolygonData& clipSp
 	float slope0 = GetSlope(v0, v1);
 	float slope1 = GetSlope(v0, v2);
 
+	const float d0 = GetInverseDepth(v0);
+	const float depthSlope0 = GetVerticalGradient(d0, GetInverseDepth(v1), v1.GetY() - v0.GetY());
+	const float depthSlope1 = GetVerticalGradient(d0, GetInverseDepth(v2), v2.GetY() - v0.GetY());
+
 	const int sourceY = static_cast<int>(std::ceil(v0.GetY() - 0.5f));
 	const int targetY = static_cast<int>(std::ceil(v2.GetY() - 0.5f));
 
-	for (int y = sourceY; y < targetY; ++y)
+	for (int y = max(sourceY, target.clipTop); y < min(targetY, target.clipBottom); ++y)
 	{
-		const float point0 = GetHorizontalGradient(slope0, y, v0.GetY(), v0.GetX());
-		const float point1 = GetHorizontalGradient(slope1, y, v0.GetY(), v0.GetX());
+		FlatLineData lineData;
 
-		int sourceX = static_cast<int>(std::ceil(point0 - 0.5f));
-		int targetX = static_cast<int>(std::ceil(point1 - 0.5f));
+		lineData.sourceSlope = GetHorizontalGradient(slope0, y, v0.GetY(), v0.GetX());
+		lineData.targetSlope = GetHorizontalGradient(slope1, y, v0.GetY(), v0.GetX());
+		lineData.sourceDepthSlope = GetHorizontalGradient(depthSlope0, y, v0.GetY(), d0);
+		lineData.targetDepthSlope = GetHorizontalGradient(depthSlope1, y, v0.GetY(), d0);
 
-		if (sourceX > targetX)
-		{
-			std::swap(sourceX, targetX);
-		}
-
-		RenderFlat(hdc, sourceX, targetX, y);
+		RenderFlat(target, lineData, y, pixel);
 	}
 }
 
@@ -185,7 +187,7 @@ void TriangleRasteriser::TopFlatShaded(const HDC& hdc, const PolygonData& clipSp
 // Precondition is that v1 and v2 perform the flat side and 
 // that v3.y > v1.y, v2.y.
 //
-void TriangleRasteriser::BottomFlatShaded(const HDC& hdc, const PolygonData& clipSpace)
+void TriangleRasteriser::BottomFlatShaded(const FrameBuffer& target, const PolygonData& clipSpace, const UINT32& pixel)
 {
 	const Vertex& v0 = clipSpace.a;
 	const Vertex& v1 = clipSpace.b;
@@ -194,23 +196,23 @@ void TriangleRasteriser::BottomFlatShaded(const HDC& hdc, const PolygonData& cli
 	const float slope0 = GetSlope(v0, v2);
 	const float slope1 = GetSlope(v1, v2);
 
+	const float d2 = GetInverseDepth(v2);
+	const float depthSlope0 = GetVerticalGradient(GetInverseDepth(v0), d2, v2.GetY() - v0.GetY());
+	const float depthSlope1 = GetVerticalGradient(GetInverseDepth(v1), d2, v2.GetY() - v1.GetY());
+
 	const int sourceY = static_cast<int>(std::ceil(v0.GetY() - 0.5f));
 	const int targetY = static_cast<int>(std::ceil(v2.GetY() - 0.5f));
 
-	for (int y = sourceY; y < targetY; ++y)
+	for (int y = max(sourceY, target.clipTop); y < min(targetY, target.clipBottom); ++y)
 	{
-		const float point0 = GetHorizontalGradient(slope0, y, v2.GetY(), v2.GetX());
-		const float point1 = GetHorizontalGradient(slope1, y, v2.GetY(), v2.GetX());
+		FlatLineData lineData;
 
-		int sourceX = static_cast<int>(std::ceil(point0 - 0.5f));
-		int targetX = static_cast<int>(std::ceil(point1 - 0.5f));
+		lineData.sourceSlope = GetHorizontalGradient(slope0, y, v2.GetY(), v2.GetX());
+		lineData.targetSlope = GetHorizontalGradient(slope1, y, v2.GetY(), v2.GetX());
+		lineData.sourceDepthSlope = GetHorizontalGradient(depthSlope0, y, v2.GetY(), d2);
+		lineData.targetDepthSlope = GetHorizontalGradient(depthSlope1, y, v2.GetY(), d2);
 
-		if (sourceX > targetX)
-		{
-			std::swap(sourceX, targetX);
-		}
-
-		RenderFlat(hdc, sourceX, targetX, y);
+		RenderFlat(target, lineData, y, pixel);
 	}
 }
 
@@ -219,7 +221,7 @@ void TriangleRasteriser::BottomFlatShaded(const HDC& hdc, const PolygonData& cli
 // Precondition is that v2 and v3 perform the flat side and 
 // that v1.y < v2.y, v3.y.
 //
-void TriangleRasteriser::TopSmoothShaded(const HDC& hdc, const PolygonData& clipSpace)
+void TriangleRasteriser::TopSmoothShaded(const FrameBuffer& target, const PolygonData& clipSpace)
 {
 	Vertex v0(clipSpace.a);
 	Vertex v1(clipSpace.b);
@@ -236,11 +238,11 @@ void TriangleRasteriser::TopSmoothShaded(const HDC& hdc, const PolygonData& clip
 	const int sourceY = static_cast<int>(std::ceil(v0.GetY() - 0.5f));
 	const int targetY = static_cast<int>(std::ceil(v2.GetY() - 0.5f));
 
-	for (int y = sourceY; y < targetY; ++y)
+	for (int y = max(sourceY, target.clipTop); y < min(targetY, target.clipBottom); ++y)
 	{
 		const SmoothLineData lineData = GetSmoothLineTop(shadeData, y);
 
-		RenderSmooth(hdc, lineData, y);
+		RenderSmooth(target, lineData, y);
 	}
 }
 
@@ -249,7 +251,7 @@ void TriangleRasteriser::TopSmoothShaded(const HDC& hdc, const PolygonData& clip
 // Precondition is that v1 and v2 perform the flat side and 
 // that v3.y > v1.y, v2.y.
 //
-void TriangleRasteriser::BottomSmoothShaded(const HDC& hdc, const PolygonData& clipSpace)
+void TriangleRasteriser::BottomSmoothShaded(const FrameBuffer& target, const PolygonData& clipSpace)
 {
 	Vertex v0(clipSpace.a);
 	Vertex v1(clipSpace.b);
@@ -266,11 +268,11 @@ void TriangleRasteriser::BottomSmoothShaded(const HDC& hdc, const PolygonData& c
 	const int sourceY = static_cast<int>(std::ceil(v0.GetY() - 0.5f));
 	const int targetY = static_cast<int>(std::ceil(v2.GetY() - 0.5f));
 
-	for (int y = sourceY; y < targetY; ++y)
+	for (int y = max(sourceY, target.clipTop); y < min(targetY, target.clipBottom); ++y)
 	{
 		const SmoothLineData lineData = GetSmoothLineBottom(shadeData, y);
 
-		RenderSmooth(hdc, lineData, y);
+		RenderSmooth(target, lineData, y);
 	}
 }
 
@@ -279,7 +281,7 @@ void TriangleRasteriser::BottomSmoothShaded(const HDC& hdc, const PolygonData& c
 // Precondition is that v2 and v3 perform the flat side and 
 // that v1.y < v2.y, v3.y.
 //
-void TriangleRasteriser::TopPhongShaded(const HDC& hdc, const PolygonData& clipSpace, const PolygonData& worldSpace, const FragmentFunction& frag)
+void TriangleRasteriser::TopPhongShaded(const FrameBuffer& target, const PolygonData& clipSpace, const PolygonData& worldSpace, const FragmentFunction& frag)
 {
 	Vertex v0(clipSpace.a);
 	Vertex v1(clipSpace.b);
@@ -303,11 +305,11 @@ void TriangleRasteriser::TopPhongShaded(const HDC& hdc, const PolygonData& clipS
 	const int sourceY = static_cast<int>(std::ceil(v0.GetY() - 0.5f));
 	const int targetY = static_cast<int>(std::ceil(v2.GetY() - 0.5f));
 
-	for (int y = sourceY; y < targetY; ++y)
+	for (int y = max(sourceY, target.clipTop); y < min(targetY, target.clipBottom); ++y)
 	{
 		const PhongLineData lineData = GetPhongLineTop(data, y);
 
-		RenderPhong(hdc, lineData, frag, y);
+		RenderPhong(target, lineData, frag, y);
 	}
 }
 
@@ -316,7 +318,7 @@ void TriangleRasteriser::TopPhongShaded(const HDC& hdc, const PolygonData& clipS
 // Precondition is that v1 and v2 perform the flat side and 
 // that v3.y > v1.y, v2.y.
 //
-void TriangleRasteriser::BottomPhongShaded(const HDC& hdc, const PolygonData& clipSpace, const PolygonData& worldSpace, const FragmentFunction& frag)
+void TriangleRasteriser::BottomPhongShaded(const FrameBuffer& target, const PolygonData& clipSpace, const PolygonData& worldSpace, const FragmentFunction& frag)
 {
 	Vertex v0(clipSpace.a);
 	Vertex v1(clipSpace.b);
@@ -342,11 +344,11 @@ void TriangleRasteriser::BottomPhongShaded(const HDC& hdc, const PolygonData& cl
 	const int sourceY = static_cast<int>(std::ceil(v0.GetY() - 0.5f));
 	const int targetY = static_cast<int>(std::ceil(v2.GetY() - 0.5f));
 
-	for (int y = sourceY; y < targetY; ++y)
+	for (int y = max(sourceY, target.clipTop); y < min(targetY, target.clipBottom); ++y)
 	{
 		const PhongLineData lineData = GetPhongLineBottom(data, y);
 
-		RenderPhong(hdc, lineData, frag, y);
+		RenderPhong(target, lineData, frag, y);
 	}
 }
 
@@ -360,7 +362,9 @@ const Vertex TriangleRasteriser::GetSplitVertex(const Vertex& a, const Vertex& b
 	// Split the triangle in a topflat and bottomflat one
 	Vertex tempVertex(a.GetX() + ((b.GetY() - a.GetY()) / (c.GetY() - a.GetY())) * (c.GetX() - a.GetX()), b.GetY(), 0);
 
-	tempVertex.SetDepth(a.GetDepth() + (c.GetDepth() - a.GetDepth()) * ((b.GetY() - a.GetY()) / (c.GetY() - a.GetY())));
+	// The split sits on the triangle's plane, so it is 1/w that is interpolated along the diagonal.
+	const float inverseDepth = GetInverseDepth(a) + (GetInverseDepth(c) - GetInverseDepth(a)) * ((b.GetY() - a.GetY()) / (c.GetY() - a.GetY()));
+	tempVertex.SetDepth(1.f / inverseDepth);
 	tempVertex.GetVertexData().SetColour(GetSplitColour(a, b, c));
 	tempVertex.GetVertexData().SetNormal(GetSplitNormal(a, b, c));
 	tempVertex.GetVertexData().SetUV(GetSplitUV(a, b, c));
@@ -482,6 +486,15 @@ float TriangleRasteriser::GetSlope(const Vertex& a, const Vertex& b)
 	return (b.GetX() - a.GetX()) / (b.GetY() - a.GetY());
 }
 
+//
+// The reciprocal of a vertex's depth, which (unlike the depth itself) can be
+// interpolated linearly across the screen.
+//
+float TriangleRasteriser::GetInverseDepth(const Vertex& v)
+{
+	return 1.0f / v.GetDepth();
+}
+
 //
 // Calculates y-related smooth shade data for rasterising top triangles.
 //
@@ -504,6 +517,8 @@ const TriangleRasteriser::SmoothShadeData TriangleRasteriser::GetSmoothDataTop(c
 		GetSlope(v0, v2),
 		GetVerticalGradient(c0, c1, ba),
 		GetVerticalGradient(c0, c2, ca),
+		GetVerticalGradient(GetInverseDepth(v0), GetInverseDepth(v1), ba),
+		GetVerticalGradient(GetInverseDepth(v0), GetInverseDepth(v2), ca),
 		clipSpace
 	};
 }
@@ -530,6 +545,8 @@ const TriangleRasteriser::SmoothShadeData TriangleRasteriser::GetSmoothDataBotto
 		GetSlope(v1, v2),
 		GetVerticalGradient(c0, c2, ca),
 		GetVerticalGradient(c1, c2, cb),
+		GetVerticalGradient(GetInverseDepth(v0), GetInverseDepth(v2), ca),
+		GetVerticalGradient(GetInverseDepth(v1), GetInverseDepth(v2), cb),
 		clipSpace
 	};
 }
@@ -541,6 +558,7 @@ const TriangleRasteriser::SmoothLineData TriangleRasteriser::GetSmoothLineTop(co
 {
 	const Vertex& v0(slopeData.clipSpace.a);
 	const UnclampedColour c0(v0.GetVertexData().GetColour());
+	const float d0 = GetInverseDepth(v0);
 
 	SmoothLineData data;
 
@@ -549,6 +567,9 @@ const TriangleRasteriser::SmoothLineData TriangleRasteriser::GetSmoothLineTop(co
 	data.sourceColourSlope = GetHorizontalGradient(slopeData.sourceColourSlope, pos, v0.GetY(), c0);
 	data.targetColourSlope = GetHorizontalGradient(slopeData.targetColourSlope, pos, v0.GetY(), c0);
 	data.horizontalColourSlope = (data.targetColourSlope - data.sourceColourSlope) / (data.targetSlope - data.sourceSlope);
+	data.sourceDepthSlope = GetHorizontalGradient(slopeData.sourceDepthSlope, pos, v0.GetY(), d0);
+	data.targetDepthSlope = GetHorizontalGradient(slopeData.targetDepthSlope, pos, v0.GetY(), d0);
+	data.horizontalDepthSlope = (data.targetDepthSlope - data.sourceDepthSlope) / (data.targetSlope - data.sourceSlope);
 
 	return data;
 }
@@ -560,6 +581,7 @@ const TriangleRasteriser::SmoothLineData TriangleRasteriser::GetSmoothLineBottom
 {
 	const Vertex& v2(slopeData.clipSpace.c);
 	const UnclampedColour c2(v2.GetVertexData().GetColour());
+	const float d2 = GetInverseDepth(v2);
 
 	SmoothLineData data;
 
@@ -568,6 +590,9 @@ const TriangleRasteriser::SmoothLineData TriangleRasteriser::GetSmoothLineBottom
 	data.sourceColourSlope = GetHorizontalGradient(slopeData.sourceColourSlope, pos, v2.GetY(), c2);
 	data.targetColourSlope = GetHorizontalGradient(slopeData.targetColourSlope, pos, v2.GetY(), c2);
 	data.horizontalColourSlope = (data.targetColourSlope - data.sourceColourSlope) / (data.targetSlope - data.sourceSlope);
+	data.sourceDepthSlope = GetHorizontalGradient(slopeData.sourceDepthSlope, pos, v2.GetY(), d2);
+	data.targetDepthSlope = GetHorizontalGradient(slopeData.targetDepthSlope, pos, v2.GetY(), d2);
+	data.horizontalDepthSlope = (data.targetDepthSlope - data.sourceDepthSlope) / (data.targetSlope - data.sourceSlope);
 
 	return data;
 }
@@ -615,6 +640,8 @@ const TriangleRasteriser::PhongShadeData TriangleRasteriser::GetPhongDataTop(con
 		GetVerticalGradient(p0, p2, ca),
 		GetVerticalGradient(u0, u1, ba),
 		GetVerticalGradient(u0, u2, ca),
+		GetVerticalGradient(GetInverseDepth(v0), GetInverseDepth(v1), ba),
+		GetVerticalGradient(GetInverseDepth(v0), GetInverseDepth(v2), ca),
 		u0,
 		u1,
 		u2,
@@ -665,6 +692,8 @@ const TriangleRasteriser::PhongShadeData TriangleRasteriser::GetPhongDataBottom(
 		GetVerticalGradient(p1, p2, cb),
 		GetVerticalGradient(u0, u2, ca),
 		GetVerticalGradient(u1, u2, cb),
+		GetVerticalGradient(GetInverseDepth(v0), GetInverseDepth(v2), ca),
+		GetVerticalGradient(GetInverseDepth(v1), GetInverseDepth(v2), cb),
 		u0,
 		u1,
 		u2,
@@ -700,6 +729,10 @@ const TriangleRasteriser::PhongLineData TriangleRasteriser::GetPhongLineTop(cons
 	data.targetUVSlope = GetHorizontalGradient(slopeData.targetUVSlope, pos, vertx.GetY(), uv);
 	data.horizontalUVSlope = (data.targetUVSlope - data.sourceUVSlope) / (data.targetSlope - data.sourceSlope);
 
+	data.sourceDepthSlope = GetHorizontalGradient(slopeData.sourceDepthSlope, pos, vertx.GetY(), GetInverseDepth(vertx));
+	data.targetDepthSlope = GetHorizontalGradient(slopeData.targetDepthSlope, pos, vertx.GetY(), GetInverseDepth(vertx));
+	data.horizontalDepthSlope = (data.targetDepthSlope - data.sourceDepthSlope) / (data.targetSlope - data.sourceSlope);
+
 	return data;
 }
 
@@ -730,6 +763,10 @@ const TriangleRasteriser::PhongLineData TriangleRasteriser::GetPhongLineBottom(c
 	data.targetUVSlope = GetHorizontalGradient(slopeData.targetUVSlope, pos, vertx.GetY(), uv);
 	data.horizontalUVSlope = (data.targetUVSlope - data.sourceUVSlope) / (data.targetSlope - data.sourceSlope);
 
+	data.sourceDepthSlope = GetHorizontalGradient(slopeData.sourceDepthSlope, pos, vertx.GetY(), GetInverseDepth(vertx));
+	data.targetDepthSlope = GetHorizontalGradient(slopeData.targetDepthSlope, pos, vertx.GetY(), GetInverseDepth(vertx));
+	data.horizontalDepthSlope = (data.targetDepthSlope - data.sourceDepthSlope) / (data.targetSlope - data.sourceSlope);
+
 	return data;
 }
 
@@ -748,67 +785,124 @@ void TriangleRasteriser::AdjustUV(Vector3& uv, const float& z)
 }
 
 //
-// Applies perspective correction on a set of UV coordinates.
+// Renders a generif flat shaded triangle line.
 //
-void TriangleRasteriser::ApplyUV(Vector3& uv)
+void TriangleRasteriser::RenderFlat(const FrameBuffer& target, const FlatLineData& lineData, const int& pos, const UINT32& pixel)
 {
-	const float u = uv.GetX() / uv.GetZ();
-	const float v = uv.GetY() / uv.GetZ();
-	constexpr float z = 0;
+	float sourceSlope = lineData.sourceSlope;
+	float targetSlope = lineData.targetSlope;
+	float sourceDepth = lineData.sourceDepthSlope;
+	float targetDepth = lineData.targetDepthSlope;
 
-	uv.SetX(u);
-	uv.SetY(v);
-	uv.SetZ(z);
-}
+	if (sourceSlope > targetSlope)
+	{
+		std::swap(sourceSlope, targetSlope);
+		std::swap(sourceDepth, targetDepth);
+	}
 
-//
-// Renders a generif flat shaded triangle line.
-//
-void TriangleRasteriser::RenderFlat(const HDC& hdc, const int& start, const int& end, const int& pos)
-{
-	MoveToEx(hdc, start, pos, NULL);
-	LineTo(hdc, end, pos);
+	const int sourceX = static_cast<int>(std::ceil(sourceSlope - 0.5f));
+	const int targetX = static_cast<int>(std::ceil(targetSlope - 0.5f));
+	const float depthSlope = (targetDepth - sourceDepth) / (targetSlope - sourceSlope);
+
+	UINT32* row = target.GetRow(pos);
+	float* depthRow = target.GetDepthRow(pos);
+
+	for (int x = max(sourceX, target.clipLeft); x < min(targetX, target.clipRight); ++x)
+	{
+		const float depth = sourceDepth + depthSlope * (static_cast<float>(x) + 0.5f - sourceSlope);
+
+		if (depth > depthRow[x])
+		{
+			depthRow[x] = depth;
+			row[x] = pixel;
+		}
+	}
 }
 
 //
 // Renders a generic smooth shaded tirangle line.
 //
-void TriangleRasteriser::RenderSmooth(const HDC& hdc, const SmoothLineData& lineData, const int& pos)
+void TriangleRasteriser::RenderSmooth(const FrameBuffer& target, const SmoothLineData& lineData, const int& pos)
 {
 	const int sourceX = static_cast<int>(std::ceil(lineData.sourceSlope - 0.5f));
 	const int targetX = static_cast<int>(std::ceil(lineData.targetSlope - 0.5f));
 
-	for (int x = sourceX; x < targetX; ++x)
+	UINT32* row = target.GetRow(pos);
+	float* depthRow = target.GetDepthRow(pos);
+
+	for (int x = max(sourceX, target.clipLeft); x < min(targetX, target.clipRight); ++x)
 	{
+		const float depth = lineData.sourceDepthSlope + lineData.horizontalDepthSlope * (static_cast<float>(x) + 0.5f - lineData.sourceSlope);
+
+		if (depth <= depthRow[x])
+		{
+			continue;
+		}
+
 		const UnclampedColour colour(lineData.sourceColourSlope + lineData.horizontalColourSlope * (static_cast<float>(x) + 0.5f - sourceX));
-		const COLORREF pixelColour = RGB(colour.GetRed() * 255, colour.GetGreen() * 255, colour.GetBlue() * 255);
 
-		SetPixelV(hdc, x, pos, pixelColour);
+		depthRow[x] = depth;
+		row[x] = FrameBuffer::Pack(colour.GetRed(), colour.GetGreen(), colour.GetBlue());
 	}
 }
 
 //
-// Renders a generic phong shaded triangle line.
+// Renders a generic phong shaded triangle line. The depth test runs before
+// the fragment function so that hidden fragments are never shaded, and the
+// visible ones are handed over in spans.
 //
-void TriangleRasteriser::RenderPhong(const HDC& hdc, const PhongLineData& lineData, const FragmentFunction& frag, const int& pos)
+void TriangleRasteriser::RenderPhong(const FrameBuffer& target, const PhongLineData& lineData, const FragmentFunction& frag, const int& pos)
 {
 	const int sourceX = static_cast<int>(std::ceil(lineData.sourceSlope - 0.5f));
 	const int targetX = static_cast<int>(std::ceil(lineData.targetSlope - 0.5f));
 
-	for (int x = sourceX; x < targetX; ++x)
+	const int startX = max(sourceX, target.clipLeft);
+	const int endX = min(targetX, target.clipRight);
+
+	UINT32* row = target.GetRow(pos);
+	float* depthRow = target.GetDepthRow(pos);
+
+	FragmentSpan span;
+	FragmentGradients gradients;
+
+	gradients.worldStep = lineData.horizontalWorldSlope;
+	gradients.normalStep = lineData.horizontalNormalSlope;
+	gradients.uvStep = lineData.horizontalUVSlope;
+
+	for (int spanX = startX; spanX < endX; spanX += FRAGMENT_SPAN_LENGTH)
 	{
-		const Vector3 normal(Vector3::NormaliseVector(lineData.sourceNormalSlope + lineData.horizontalNormalSlope * (static_cast<float>(x) + 0.5f - sourceX)));
-		Vector3 uv(lineData.sourceUVSlope + lineData.horizontalUVSlope * (static_cast<float>(x) + 0.5f - sourceX));
-		ApplyUV(uv);
+		const int spanEnd = min(spanX + FRAGMENT_SPAN_LENGTH, endX);
 
-		Vertex fragment = lineData.sourceWorldSlope + lineData.horizontalWorldSlope * (static_cast<float>(x) + 0.5f - sourceX);
+		span.count = 0;
 
-		fragment.GetVertexData().SetNormal(normal);
-		fragment.GetVertexData().SetUV(uv);
+		for (int x = spanX; x < spanEnd; ++x)
+		{
+			const float depth = lineData.sourceDepthSlope + lineData.horizontalDepthSlope * (static_cast<float>(x) + 0.5f - lineData.sourceSlope);
 
-		const Colour colour = frag(fragment);
-		const COLORREF pixelColour = RGB(colour.GetRed() * 255, colour.GetGreen() * 255, colour.GetBlue() * 255);
+			if (depth <= depthRow[x])
+			{
+				continue;
+			}
 
-		SetPixelV(hdc, x, pos, pixelColour);
+			depthRow[x] = depth;
+			span.offsets[span.count++] = x - spanX;
+		}
+
+		if (!span.count)
+		{
+			continue;
+		}
+
+		const float offset = static_cast<float>(spanX) + 0.5f - sourceX;
+
+		gradients.world = lineData.sourceWorldSlope + lineData.horizontalWorldSlope * offset;
+		gradients.normal = lineData.sourceNormalSlope + lineData.horizontalNormalSlope * offset;
+		gradients.uv = lineData.sourceUVSlope + lineData.horizontalUVSlope * offset;
+
+		span.x = spanX;
+		span.y = pos;
+		span.Interpolate(gradients);
+
+		frag.Shade(span, row + spanX);
 	}
-}
\ No newline at end of file
+}
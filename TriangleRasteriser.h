@@ -4,19 +4,13 @@
 #include <functional>
 #include "Polygon3D.h"
 #include "UnclampedColour.h"
+#include "FrameBuffer.h"
+#include "FragmentFunction.h"
 
 // Template shorthand definitions
 #define ARITM_TEMP(t_name) template<typename t_name>
 #define ARTIM_TEMP ARITM_TEMP(TAritm)
 
-//
-// Represents a fragment function handler.
-//
-struct FragmentFunction
-{
-	virtual const Colour operator()(const Vertex& v) const = 0;
-};
-
 //
 // Rasterises a triangle using the standard solid rasterisation
 // technique.
@@ -43,6 +37,18 @@ class TriangleRasteriser
 		Vertex& c;
 	};
 
+	//
+	// Data to be used for rendering flat shaded polygons, on a single line.
+	//
+	struct FlatLineData
+	{
+		float sourceSlope{ 0 };
+		float targetSlope{ 0 };
+
+		float sourceDepthSlope{ 0 };
+		float targetDepthSlope{ 0 };
+	};
+
 	//
 	// Data to be supplied for smooth shading.
 	//
@@ -54,6 +60,9 @@ class TriangleRasteriser
 		UnclampedColour sourceColourSlope;
 		UnclampedColour targetColourSlope;
 
+		float sourceDepthSlope{ 0 };
+		float targetDepthSlope{ 0 };
+
 		const PolygonData& clipSpace;
 	};
 
@@ -68,6 +77,10 @@ class TriangleRasteriser
 		UnclampedColour sourceColourSlope;
 		UnclampedColour targetColourSlope;
 		UnclampedColour horizontalColourSlope;
+
+		float sourceDepthSlope{ 0 };
+		float targetDepthSlope{ 0 };
+		float horizontalDepthSlope{ 0 };
 	};
 
 	//
@@ -96,6 +109,9 @@ class TriangleRasteriser
 		Vector3 sourceUVSlope;
 		Vector3 targetUVSlope;
 
+		float sourceDepthSlope{ 0 };
+		float targetDepthSlope{ 0 };
+
 		Vector3 uv0;
 		Vector3 uv1;
 		Vector3 uv2;
@@ -123,15 +139,19 @@ class TriangleRasteriser
 		Vector3 sourceUVSlope;
 		Vector3 targetUVSlope;
 		Vector3 horizontalUVSlope;
+
+		float sourceDepthSlope{ 0 };
+		float targetDepthSlope{ 0 };
+		float horizontalDepthSlope{ 0 };
 	};
 
 public:
 	//
 	// Drawing handlers.
 	//
-	static void DrawFlat(const HDC& hdc, const PolygonData& clipSpace);
-	static void DrawSmooth(const HDC& hdc, const PolygonData& clipSpace);
-	static void DrawPhong(const HDC& hdc, const PolygonData& clipSpace, const PolygonData& worldSpace, const FragmentFunction& frag);
+	static void DrawFlat(const FrameBuffer& target, const PolygonData& clipSpace, const Colour& colour);
+	static void DrawSmooth(const FrameBuffer& target, const PolygonData& clipSpace);
+	static void DrawPhong(const FrameBuffer& target, const PolygonData& clipSpace, const PolygonData& worldSpace, const FragmentFunction& frag);
 
 private:
 	//
@@ -145,20 +165,20 @@ private:
 	//
 	// Flat shading callbacks.
 	//
-	static void TopFlatShaded(const HDC& hdc, const PolygonData& clipSpace);
-	static void BottomFlatShaded(const HDC& hdc, const PolygonData& clipSpace);
+	static void TopFlatShaded(const FrameBuffer& target, const PolygonData& clipSpace, const UINT32& pixel);
+	static void BottomFlatShaded(const FrameBuffer& target, const PolygonData& clipSpace, const UINT32& pixel);
 
 	//
 	// Smooth shading callbacks.
 	//
-	static void TopSmoothShaded(const HDC& hdc, const PolygonData& clipSpace);
-	static void BottomSmoothShaded(const HDC& hdc, const PolygonData& clipSpace);
+	static void TopSmoothShaded(const FrameBuffer& target, const PolygonData& clipSpace);
+	static void BottomSmoothShaded(const FrameBuffer& target, const PolygonData& clipSpace);
 
 	//
 	// Phong shading callbacks.
 	//
-	static void TopPhongShaded(const HDC& hdc, const PolygonData& clipSpace, const PolygonData& worldSpace, const FragmentFunction& frag);
-	static void BottomPhongShaded(const HDC& hdc, const PolygonData& clipSpace, const PolygonData& worldSpace, const FragmentFunction& frag);
+	static void TopPhongShaded(const FrameBuffer& target, const PolygonData& clipSpace, const PolygonData& worldSpace, const FragmentFunction& frag);
+	static void BottomPhongShaded(const FrameBuffer& target, const PolygonData& clipSpace, const PolygonData& worldSpace, const FragmentFunction& frag);
 
 	//
 	// Splitting systems.
@@ -176,6 +196,7 @@ private:
 	ARTIM_TEMP inline static TAritm GetVerticalGradient(const TAritm& a, const TAritm& b, const float& den);
 
 	static float GetSlope(const Vertex& a, const Vertex& b);
+	static float GetInverseDepth(const Vertex& v);
 
 	static const SmoothShadeData GetSmoothDataTop(const PolygonData& clipSpace);
 	static const SmoothShadeData GetSmoothDataBottom(const PolygonData& clipSpace);
@@ -190,11 +211,10 @@ private:
 	static const PhongLineData GetPhongLineBottom(const PhongShadeData& slopeData, const int& pos);
 
 	static void AdjustUV(Vector3& uv, const float& z);
-	static void ApplyUV(Vector3& uv);
 
-	static void RenderFlat(const HDC& hdc, const int& start, const int& end, const int& pos);
-	static void RenderSmooth(const HDC& hdc, const SmoothLineData& lineData, const int& pos);
-	static void RenderPhong(const HDC& hdc, const PhongLineData& lineData, const FragmentFunction& frag, const int& pos);
+	static void RenderFlat(const FrameBuffer& target, const FlatLineData& lineData, const int& pos, const UINT32& pixel);
+	static void RenderSmooth(const FrameBuffer& target, const SmoothLineData& lineData, const int& pos);
+	static void RenderPhong(const FrameBuffer& target, const PhongLineData& lineData, const FragmentFunction& frag, const int& pos);
 };
 
 //
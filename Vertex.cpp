@@ -137,9 +137,11 @@ Vertex Vertex::Lerp(const Vertex& lhs, const Vertex& rhs, const float& alpha)
 	lerp.SetY(rhs.GetY() * alpha + lhs.GetY() * (1 - alpha));
 	lerp.SetZ(rhs.GetZ() * alpha + lhs.GetZ() * (1 - alpha));
 	lerp.SetW(rhs.GetW() * alpha + lhs.GetW() * (1 - alpha));
+	lerp.SetDepth(rhs.GetDepth() * alpha + lhs.GetDepth() * (1 - alpha));
 
 	lerp.GetVertexData().SetNormal(Vector3::Lerp(lhs.GetVertexData().GetNormal(), rhs.GetVertexData().GetNormal(), alpha));
 	lerp.GetVertexData().SetColour(Colour::Lerp(lhs.GetVertexData().GetColour(), rhs.GetVertexData().GetColour(), alpha));
+	lerp.GetVertexData().SetUV(Vector3::Lerp(lhs.GetVertexData().GetUV(), rhs.GetVertexData().GetUV(), alpha));
 
 	return lerp;
 }
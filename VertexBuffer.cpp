@@ -0,0 +1,189 @@
+#include "VertexBuffer.h"
+
+//
+// Pushes a vertex, along with all of its attributes.
+//
+void VertexBuffer::Add(const Vertex& vertex)
+{
+	_x.push_back(vertex.GetX());
+	_y.push_back(vertex.GetY());
+	_z.push_back(vertex.GetZ());
+	_w.push_back(vertex.GetW());
+	_depth.push_back(vertex.GetDepth());
+
+	_normals.push_back(vertex.GetVertexData().GetNormal());
+	_colours.push_back(vertex.GetVertexData().GetColour());
+	_uvs.push_back(vertex.GetVertexData().GetUV());
+}
+
+//
+// Resizes every array, new vertices sit at the origin with empty attributes.
+//
+void VertexBuffer::Resize(const size_t& count)
+{
+	_x.resize(count, 0.f);
+	_y.resize(count, 0.f);
+	_z.resize(count, 0.f);
+	_w.resize(count, 1.f);
+	_depth.resize(count, 0.f);
+
+	_normals.resize(count);
+	_colours.resize(count);
+	_uvs.resize(count);
+}
+
+//
+// Removes every vertex.
+//
+void VertexBuffer::Clear()
+{
+	Resize(0);
+}
+
+//
+// The number of vertices.
+//
+const size_t VertexBuffer::GetCount() const
+{
+	return _x.size();
+}
+
+//
+// Assembles the full vertex at the given index.
+//
+const Vertex VertexBuffer::GetVertex(const size_t& index) const
+{
+	Vertex vertex(_x[index], _y[index], _z[index], _w[index]);
+
+	vertex.SetDepth(_depth[index]);
+	vertex.GetVertexData().SetNormal(_normals[index]);
+	vertex.GetVertexData().SetColour(_colours[index]);
+	vertex.GetVertexData().SetUV(_uvs[index]);
+
+	return vertex;
+}
+
+//
+// The X, Y and Z components of the position at the given index.
+//
+const Vector3 VertexBuffer::GetPosition(const size_t& index) const
+{
+	return Vector3(_x[index], _y[index], _z[index]);
+}
+
+//
+// Position components.
+//
+const float* VertexBuffer::GetX() const
+{
+	return _x.data();
+}
+
+const float* VertexBuffer::GetY() const
+{
+	return _y.data();
+}
+
+const float* VertexBuffer::GetZ() const
+{
+	return _z.data();
+}
+
+const float* VertexBuffer::GetW() const
+{
+	return _w.data();
+}
+
+const float* VertexBuffer::GetDepth() const
+{
+	return _depth.data();
+}
+
+float* VertexBuffer::GetX()
+{
+	return _x.data();
+}
+
+float* VertexBuffer::GetY()
+{
+	return _y.data();
+}
+
+float* VertexBuffer::GetZ()
+{
+	return _z.data();
+}
+
+float* VertexBuffer::GetW()
+{
+	return _w.data();
+}
+
+float* VertexBuffer::GetDepth()
+{
+	return _depth.data();
+}
+
+//
+// The normal of the vertex at the given index.
+//
+const Vector3& VertexBuffer::GetNormal(const size_t& index) const
+{
+	return _normals[index];
+}
+
+//
+// Updates the normal of the vertex at the given index.
+//
+void VertexBuffer::SetNormal(const size_t& index, const Vector3& normal)
+{
+	_normals[index] = normal;
+}
+
+//
+// The colour of the vertex at the given index.
+//
+const Colour& VertexBuffer::GetColour(const size_t& index) const
+{
+	return _colours[index];
+}
+
+//
+// Updates the colour of the vertex at the given index.
+//
+void VertexBuffer::SetColour(const size_t& index, const Colour& colour)
+{
+	_colours[index] = colour;
+}
+
+//
+// The UV coordinates of the vertex at the given index.
+//
+const Vector3& VertexBuffer::GetUV(const size_t& index) const
+{
+	return _uvs[index];
+}
+
+//
+// Updates the UV coordinates of the vertex at the given index.
+//
+void VertexBuffer::SetUV(const size_t& index, const Vector3& uv)
+{
+	_uvs[index] = uv;
+}
+
+//
+// Every vertex normal.
+//
+const std::vector<Vector3>& VertexBuffer::GetNormals() const
+{
+	return _normals;
+}
+
+//
+// Every vertex normal.
+//
+std::vector<Vector3>& VertexBuffer::GetNormals()
+{
+	return _normals;
+}
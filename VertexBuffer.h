@@ -0,0 +1,70 @@
+#pragma once
+#include <vector>
+#include "Vector.h"
+#include "Vertex.h"
+#include "Colour.h"
+
+//
+// Stores vertices as a structure of arrays: every component of the positions
+// (and the depth) lives in its own contiguous array, as does every vertex
+// attribute, so that transforming positions never streams through normals,
+// colours or UVs.
+//
+class VertexBuffer
+{
+public:
+	//
+	// Size management.
+	//
+	void Add(const Vertex& vertex);
+	void Resize(const size_t& count);
+	void Clear();
+	const size_t GetCount() const;
+
+	//
+	// Assembles the full vertex (position, depth and attributes) at the given index.
+	//
+	const Vertex GetVertex(const size_t& index) const;
+	const Vector3 GetPosition(const size_t& index) const;
+
+	//
+	// Position components.
+	//
+	const float* GetX() const;
+	const float* GetY() const;
+	const float* GetZ() const;
+	const float* GetW() const;
+	const float* GetDepth() const;
+
+	float* GetX();
+	float* GetY();
+	float* GetZ();
+	float* GetW();
+	float* GetDepth();
+
+	//
+	// Vertex attributes.
+	//
+	const Vector3& GetNormal(const size_t& index) const;
+	void SetNormal(const size_t& index, const Vector3& normal);
+
+	const Colour& GetColour(const size_t& index) const;
+	void SetColour(const size_t& index, const Colour& colour);
+
+	const Vector3& GetUV(const size_t& index) const;
+	void SetUV(const size_t& index, const Vector3& uv);
+
+	const std::vector<Vector3>& GetNormals() const;
+	std::vector<Vector3>& GetNormals();
+
+private:
+	std::vector<float> _x;
+	std::vector<float> _y;
+	std::vector<float> _z;
+	std::vector<float> _w;
+	std::vector<float> _depth;
+
+	std::vector<Vector3> _normals;
+	std::vector<Colour> _colours;
+	std::vector<Vector3> _uvs;
+};